@@ -33,12 +33,20 @@ UI_DIR = $$PWD/build/.ui
 
 SOURCES += \
         main.cpp \
+        cli/batchrunner.cpp \
         mainwindow.cpp \
         models/user.cpp \
         models/car.cpp \
         models/rental.cpp \
         models/fine.cpp \
+        models/rentalview.cpp \
         database/databasemanager.cpp \
+        database/databaseconfig.cpp \
+        database/connectionpool.cpp \
+        database/asyncdatabase.cpp \
+        database/useridallocator.cpp \
+        database/rentalquerybuilder.cpp \
+        database/bookingindex.cpp \
         patterns/pricingstrategy.cpp \
         patterns/carstatusobserver.cpp \
         services/rentalservice.cpp \
@@ -46,6 +54,8 @@ SOURCES += \
         services/carservice.cpp \
         services/userservice.cpp \
         services/rentalsearchservice.cpp \
+        services/overduefineengine.cpp \
+        services/maintenancescheduler.cpp \
         managers/reportmanager.cpp \
         ui/loginwindow.cpp \
         ui/clientmainwindow.cpp \
@@ -55,17 +65,34 @@ SOURCES += \
         ui/reportswindow.cpp \
         ui/importexportdialog.cpp \
         ui/registerdialog.cpp \
+        ui/cartablemodel.cpp \
+        ui/rentaltablemodel.cpp \
+        ui/usertablemodel.cpp \
+        ui/tableviewutils.cpp \
         utils/dataexporter.cpp \
         utils/dataimporter.cpp \
-        utils/dateutils.cpp
+        utils/dateutils.cpp \
+        utils/jsonstreamwriter.cpp \
+        utils/timerwheel.cpp
 
 HEADERS += \
         mainwindow.h \
+        cli/batchrunner.h \
         models/user.h \
         models/car.h \
         models/rental.h \
         models/fine.h \
+        models/rentalview.h \
         database/databasemanager.h \
+        database/rowmapper.h \
+        database/databaseconfig.h \
+        database/connectionpool.h \
+        database/asyncdatabase.h \
+        database/useridallocator.h \
+        database/rentalquerybuilder.h \
+        database/entitycache.h \
+        database/bookingindex.h \
+        database/overduefinestatements.h \
         patterns/pricingstrategy.h \
         patterns/carstatusobserver.h \
         services/rentalservice.h \
@@ -73,6 +100,8 @@ HEADERS += \
         services/carservice.h \
         services/userservice.h \
         services/rentalsearchservice.h \
+        services/overduefineengine.h \
+        services/maintenancescheduler.h \
         managers/reportmanager.h \
         ui/loginwindow.h \
         ui/clientmainwindow.h \
@@ -82,9 +111,15 @@ HEADERS += \
         ui/reportswindow.h \
         ui/importexportdialog.h \
         ui/registerdialog.h \
+        ui/cartablemodel.h \
+        ui/rentaltablemodel.h \
+        ui/usertablemodel.h \
+        ui/tableviewutils.h \
         utils/dataexporter.h \
         utils/dataimporter.h \
-        utils/dateutils.h
+        utils/dateutils.h \
+        utils/jsonstreamwriter.h \
+        utils/timerwheel.h
 
 FORMS += \
         mainwindow.ui
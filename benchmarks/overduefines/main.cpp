@@ -0,0 +1,193 @@
+// Сравнение путей OverdueFineEngine: запись каждого штрафа против двух запросов
+// DatabaseManager::applyOverdueFines при разной доле просроченных аренд.
+// Запуск: overduefines [активных аренд] [просроченных ...], по умолчанию 20000 и 250 500 1000 2000 4000.
+// БД приложения создается во временной папке (CAR_RENTAL_DB_DIR), перед каждым замером
+// аренды и штрафы заполняются заново. Замеряются два прохода движка: первый день
+// (новые штрафы и обновление старых) и следующий (обновление всех штрафов, обычная работа)
+#include "../../database/databasemanager.h"
+#include "../../services/overduefineengine.h"
+#include <QCoreApplication>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QList>
+#include <QTextStream>
+#include <QDate>
+
+static const int CAR_COUNT = 1000;
+static const char* BENCH_CONNECTION = "overduefines";
+
+struct BenchResult {
+    qint64 firstDayMs;
+    qint64 nextDayMs;
+    int applied;
+    int fineCount;
+    double fineTotal;
+
+    BenchResult() : firstDayMs(0), nextDayMs(0), applied(0), fineCount(0), fineTotal(0) {}
+};
+
+static bool exec(QSqlQuery& query, const QString& sql)
+{
+    if (!query.exec(sql)) {
+        QTextStream(stderr) << "Ошибка: " << query.lastError().text() << " в " << sql << endl;
+        return false;
+    }
+    return true;
+}
+
+static bool populateCars(QSqlDatabase& database)
+{
+    QSqlQuery query(database);
+    if (!database.transaction() || !exec(query, "DELETE FROM cars")) {
+        return false;
+    }
+    query.prepare("INSERT INTO cars (brand, model, status, daily_price) VALUES (?, ?, 1, ?)");
+    for (int i = 0; i < CAR_COUNT; ++i) {
+        query.addBindValue(QString("Brand%1").arg(i % 50));
+        query.addBindValue(QString("Model%1").arg(i));
+        query.addBindValue(1000.0 + (i % 20) * 250.0);
+        if (!query.exec()) {
+            return false;
+        }
+    }
+    return database.commit();
+}
+
+// Первые overdueCount аренд просрочены еще до первого замеренного дня,
+// у половины из них уже есть устаревший штраф
+static bool populateRentals(QSqlDatabase& database, int activeCount, int overdueCount, const QDate& firstDay)
+{
+    const qint64 day = firstDay.toJulianDay();
+    QSqlQuery clear(database);
+    if (!database.transaction() || !exec(clear, "DELETE FROM fines") || !exec(clear, "DELETE FROM rentals")) {
+        return false;
+    }
+
+    QSqlQuery carIds(database);
+    if (!exec(carIds, "SELECT id FROM cars ORDER BY id")) {
+        return false;
+    }
+    QList<int> cars;
+    while (carIds.next()) {
+        cars.append(carIds.value(0).toInt());
+    }
+
+    QSqlQuery rental(database);
+    rental.prepare("INSERT INTO rentals (car_id, user_id, start_date, end_date, total_cost, is_completed) "
+                   "VALUES (?, 1, ?, ?, 0, 0)");
+    QSqlQuery fine(database);
+    fine.prepare("INSERT INTO fines (rental_id, amount, date, reason) VALUES (?, 1, ?, 'old')");
+    for (int i = 0; i < activeCount; ++i) {
+        bool overdue = i < overdueCount;
+        qint64 endDay = overdue ? day - 1 - (i % 30) : day + 2 + (i % 30);
+        rental.addBindValue(cars.at(i % cars.size()));
+        rental.addBindValue(endDay - 7);
+        rental.addBindValue(endDay);
+        if (!rental.exec()) {
+            return false;
+        }
+        if (overdue && i % 2 == 0) {
+            fine.addBindValue(rental.lastInsertId());
+            fine.addBindValue(endDay);
+            if (!fine.exec()) {
+                return false;
+            }
+        }
+    }
+    return database.commit();
+}
+
+static BenchResult runCase(QSqlDatabase& database, int activeCount, int overdueCount,
+                           OverdueFineEngine::SweepMode mode)
+{
+    BenchResult result;
+    const QDate firstDay = QDate::currentDate();
+    DatabaseManager& dbManager = DatabaseManager::getInstance();
+    OverdueFineEngine& engine = OverdueFineEngine::getInstance();
+    if (!populateRentals(database, activeCount, overdueCount, firstDay) ||
+        !dbManager.setMaintenanceValue("overdue_sweep_day", 0)) {
+        QTextStream(stderr) << "Не удалось подготовить БД: " << database.lastError().text() << endl;
+        return result;
+    }
+    engine.setSweepMode(mode);
+    engine.invalidate();
+
+    QElapsedTimer timer;
+    timer.start();
+    int firstApplied = engine.sweep(firstDay);
+    result.firstDayMs = timer.restart();
+    int nextApplied = engine.sweep(firstDay.addDays(1));
+    result.nextDayMs = timer.elapsed();
+    result.applied = firstApplied < 0 || nextApplied < 0 ? -1 : firstApplied + nextApplied;
+
+    QSqlQuery check(database);
+    if (exec(check, "SELECT COUNT(*), COALESCE(SUM(amount), 0) FROM fines") && check.next()) {
+        result.fineCount = check.value(0).toInt();
+        result.fineTotal = check.value(1).toDouble();
+    }
+    return result;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    QList<int> sizes;
+    for (const QString& arg : app.arguments().mid(1)) {
+        if (arg.toInt() > 0) {
+            sizes.append(arg.toInt());
+        }
+    }
+    int activeCount = sizes.isEmpty() ? 20000 : sizes.takeFirst();
+    if (sizes.isEmpty()) {
+        sizes << 250 << 500 << 1000 << 2000 << 4000;
+    }
+
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        return 1;
+    }
+    // DatabaseManager создается при первом обращении - папка БД задается до него
+    qputenv("CAR_RENTAL_DB_DIR", dir.path().toLocal8Bit());
+    DatabaseManager& dbManager = DatabaseManager::getInstance();
+    if (!dbManager.initializeDatabase()) {
+        return 1;
+    }
+
+    int exitCode = 0;
+    {
+        QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", BENCH_CONNECTION);
+        database.setDatabaseName(dir.filePath("car_rental.db"));
+        if (!database.open() || !populateCars(database)) {
+            QTextStream(stderr) << "Не удалось подготовить БД: " << database.lastError().text() << endl;
+            return 1;
+        }
+
+        out << "active " << activeCount << ", auto mode: set-based from "
+            << (activeCount + OverdueFineEngine::SET_BASED_DIVISOR - 1) / OverdueFineEngine::SET_BASED_DIVISOR
+            << " overdue" << endl;
+        out << "overdue | per-row ms (day 1 / day 2) | set-based ms (day 1 / day 2) | results match" << endl;
+        for (int overdueCount : sizes) {
+            overdueCount = qMin(overdueCount, activeCount);
+            BenchResult perRow = runCase(database, activeCount, overdueCount, OverdueFineEngine::PerRowSweep);
+            BenchResult setBased = runCase(database, activeCount, overdueCount, OverdueFineEngine::SetBasedSweep);
+            bool match = perRow.applied >= 0 && setBased.applied >= 0 &&
+                         perRow.fineCount == setBased.fineCount &&
+                         qAbs(perRow.fineTotal - setBased.fineTotal) < 0.01;
+            if (!match) {
+                exitCode = 2;
+            }
+            out << overdueCount << " | " << perRow.firstDayMs << " / " << perRow.nextDayMs << " | "
+                << setBased.firstDayMs << " / " << setBased.nextDayMs << " | "
+                << (match ? "yes" : "NO") << endl;
+        }
+        database.close();
+    }
+    QSqlDatabase::removeDatabase(BENCH_CONNECTION);
+    return exitCode;
+}
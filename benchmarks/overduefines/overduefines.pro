@@ -0,0 +1,50 @@
+#-------------------------------------------------
+#
+# Бенчмарк пересчета штрафов за просрочку:
+# пути OverdueFineEngine - запись каждого штрафа против UPDATE / INSERT ... SELECT
+#
+#-------------------------------------------------
+
+QT       += core sql
+QT       -= gui
+
+TARGET = overduefines
+TEMPLATE = app
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+SOURCES += \
+        main.cpp \
+        ../../models/user.cpp \
+        ../../models/car.cpp \
+        ../../models/rental.cpp \
+        ../../models/fine.cpp \
+        ../../models/rentalview.cpp \
+        ../../database/databasemanager.cpp \
+        ../../database/databaseconfig.cpp \
+        ../../database/connectionpool.cpp \
+        ../../database/useridallocator.cpp \
+        ../../database/rentalquerybuilder.cpp \
+        ../../database/bookingindex.cpp \
+        ../../services/overduefineengine.cpp \
+        ../../utils/dateutils.cpp
+
+HEADERS += \
+        ../../models/user.h \
+        ../../models/car.h \
+        ../../models/rental.h \
+        ../../models/fine.h \
+        ../../models/rentalview.h \
+        ../../database/databasemanager.h \
+        ../../database/rowmapper.h \
+        ../../database/databaseconfig.h \
+        ../../database/connectionpool.h \
+        ../../database/useridallocator.h \
+        ../../database/rentalquerybuilder.h \
+        ../../database/entitycache.h \
+        ../../database/bookingindex.h \
+        ../../database/overduefinestatements.h \
+        ../../services/overduefineengine.h \
+        ../../utils/dateutils.h
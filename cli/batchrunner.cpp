@@ -0,0 +1,215 @@
+#include "batchrunner.h"
+#include "../database/databasemanager.h"
+#include "../services/rentalservice.h"
+#include "../managers/reportmanager.h"
+#include "../utils/dataexporter.h"
+#include "../utils/dataimporter.h"
+#include "../utils/dateutils.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QCommandLineOption>
+#include <QElapsedTimer>
+#include <cstring>
+
+bool BatchRunner::isBatchInvocation(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--batch") == 0 || std::strncmp(argv[i], "--batch=", 8) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+BatchRunner::BatchRunner()
+    : m_out(stdout), m_err(stderr), m_dbManager(nullptr)
+{
+}
+
+QDate BatchRunner::parseDate(const QString& value, const QDate& fallback, bool* ok)
+{
+    *ok = true;
+    if (value.isEmpty()) {
+        return fallback;
+    }
+    QDate date = QDate::fromString(value, "yyyy-MM-dd");
+    *ok = date.isValid();
+    return date;
+}
+
+int BatchRunner::run(const QCoreApplication& app)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Пакетный режим: штрафы, экспорт, импорт и отчеты без интерфейса");
+    parser.addHelpOption();
+    QCommandLineOption batchOption("batch", "Задача: fines, export, import или report.", "job");
+    QCommandLineOption fileOption("file", "JSON-файл для экспорта, импорта или отчета.", "path");
+    QCommandLineOption sectionOption("section", "Раздел данных: all, cars, rentals, users или fines.",
+                                     "section", "all");
+    QCommandLineOption fromOption("from", "Начало периода отчета (yyyy-MM-dd), по умолчанию - начало месяца.",
+                                  "date");
+    QCommandLineOption toOption("to", "Конец периода отчета (yyyy-MM-dd), по умолчанию - сегодня.", "date");
+    QCommandLineOption batchSizeOption("batch-size",
+                                       QString("Записей в одной транзакции импорта (0 - весь раздел), по умолчанию %1.")
+                                           .arg(DataImporter::DEFAULT_BATCH_SIZE),
+                                       "count");
+    QCommandLineOption overwriteOption("overwrite", "Импортировать записи, уже существующие в БД.");
+    parser.addOption(batchOption);
+    parser.addOption(fileOption);
+    parser.addOption(sectionOption);
+    parser.addOption(fromOption);
+    parser.addOption(toOption);
+    parser.addOption(batchSizeOption);
+    parser.addOption(overwriteOption);
+    parser.process(app);
+
+    const QString job = parser.value(batchOption);
+    const QString filePath = parser.value(fileOption);
+    const QString section = parser.value(sectionOption).toLower();
+    if (!(QStringList() << "all" << "cars" << "rentals" << "users" << "fines").contains(section)) {
+        m_err << "Неизвестный раздел данных: " << section << endl;
+        return UsageError;
+    }
+    if ((job == "export" || job == "import") && filePath.isEmpty()) {
+        m_err << "Для задачи " << job << " нужен параметр --file" << endl;
+        return UsageError;
+    }
+
+    m_dbManager = &DatabaseManager::getInstance();
+    if (!m_dbManager->initializeDatabase()) {
+        m_err << "Не удалось инициализировать базу данных" << endl;
+        return Failed;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    int exitCode = UsageError;
+    if (job == "fines") {
+        exitCode = runFines();
+    } else if (job == "export") {
+        exitCode = runExport(filePath, section);
+    } else if (job == "import") {
+        bool ok = true;
+        int batchSize = parser.isSet(batchSizeOption) ? parser.value(batchSizeOption).toInt(&ok) : -1;
+        if (!ok || batchSize < -1) {
+            m_err << "Некорректный размер пакета: " << parser.value(batchSizeOption) << endl;
+            return UsageError;
+        }
+        exitCode = runImport(filePath, section, batchSize, !parser.isSet(overwriteOption));
+    } else if (job == "report") {
+        QDate today = DateUtils::currentDate();
+        bool fromOk = false;
+        bool toOk = false;
+        QDate startDate = parseDate(parser.value(fromOption), QDate(today.year(), today.month(), 1), &fromOk);
+        QDate endDate = parseDate(parser.value(toOption), today, &toOk);
+        if (!fromOk || !toOk || startDate > endDate) {
+            m_err << "Некорректный период отчета" << endl;
+            return UsageError;
+        }
+        exitCode = runReport(startDate, endDate, filePath);
+    } else {
+        m_err << "Неизвестная задача: " << job << " (fines, export, import, report)" << endl;
+        return UsageError;
+    }
+
+    m_out << "Задача " << job << (exitCode == Success ? " выполнена" : " завершилась с ошибкой")
+          << " за " << timer.elapsed() << " мс" << endl;
+    return exitCode;
+}
+
+int BatchRunner::runFines()
+{
+    RentalService rentalService;
+    int applied = rentalService.checkAndApplyOverdueFines();
+    if (applied < 0) {
+        m_err << "Ошибка начисления штрафов за просрочку" << endl;
+        return Failed;
+    }
+    m_out << "Начислено и обновлено штрафов: " << applied << endl;
+    return Success;
+}
+
+int BatchRunner::runExport(const QString& filePath, const QString& section)
+{
+    DataExporter exporter(m_dbManager);
+    bool success = false;
+    if (section == "cars") {
+        success = exporter.exportCarsToJson(filePath);
+    } else if (section == "rentals") {
+        success = exporter.exportRentalsToJson(filePath);
+    } else if (section == "users") {
+        success = exporter.exportUsersToJson(filePath);
+    } else if (section == "fines") {
+        success = exporter.exportFinesToJson(filePath);
+    } else {
+        success = exporter.exportToJson(filePath);
+    }
+
+    if (!success) {
+        m_err << "Ошибка экспорта в " << filePath << endl;
+        return Failed;
+    }
+    m_out << "Данные экспортированы в " << filePath << endl;
+    return Success;
+}
+
+int BatchRunner::runImport(const QString& filePath, const QString& section, int batchSize, bool skipExisting)
+{
+    DataImporter importer(m_dbManager);
+    if (batchSize >= 0) {
+        importer.setBatchSize(batchSize);
+    }
+
+    ImportResult result;
+    if (section == "cars") {
+        result = importer.importCarsFromJson(filePath, skipExisting);
+    } else if (section == "rentals") {
+        result = importer.importRentalsFromJson(filePath, skipExisting);
+    } else if (section == "users") {
+        result = importer.importUsersFromJson(filePath, skipExisting);
+    } else if (section == "fines") {
+        result = importer.importFinesFromJson(filePath, skipExisting);
+    } else {
+        result = importer.importFromJson(filePath, skipExisting);
+    }
+
+    m_out << "Автомобилей: " << result.carsImported
+          << ", пользователей: " << result.usersImported
+          << ", аренд: " << result.rentalsImported
+          << ", штрафов: " << result.finesImported
+          << ", ошибок: " << result.errors
+          << " (" << QString::number(result.recordsPerSecond(), 'f', 0) << " записей/с)" << endl;
+    for (const QString& message : result.errorMessages) {
+        m_err << message << endl;
+    }
+    return result.errors == 0 ? Success : Failed;
+}
+
+int BatchRunner::runReport(const QDate& startDate, const QDate& endDate, const QString& filePath)
+{
+    if (!filePath.isEmpty()) {
+        DataExporter exporter(m_dbManager);
+        if (!exporter.exportReportToJson(filePath, startDate, endDate)) {
+            m_err << "Ошибка записи отчета в " << filePath << endl;
+            return Failed;
+        }
+        m_out << "Отчет сохранен в " << filePath << endl;
+        return Success;
+    }
+
+    ReportManager reportManager;
+    PeriodReport report = reportManager.generatePeriodReport(startDate, endDate);
+    const RevenueReport& revenue = report.revenue;
+    m_out << "Отчет за период " << startDate.toString("yyyy-MM-dd") << " - " << endDate.toString("yyyy-MM-dd") << endl
+          << "Общий доход: " << QString::number(revenue.totalRevenue, 'f', 2) << " руб" << endl
+          << "Доход от штрафов: " << QString::number(revenue.totalFines, 'f', 2) << " руб" << endl
+          << "Всего аренд: " << revenue.totalRentals << endl
+          << "Активных аренд: " << revenue.activeRentals << endl
+          << "Средняя длительность: " << QString::number(revenue.averageRentalDuration, 'f', 1) << " дней" << endl
+          << "Загруженность парка: " << QString::number(revenue.fleetUtilization, 'f', 1) << "%" << endl;
+    for (const CarStatistics& car : report.popularCars) {
+        m_out << "  " << car.carName << ": " << car.rentalCount << " аренд, "
+              << QString::number(car.totalRevenue, 'f', 2) << " руб" << endl;
+    }
+    return Success;
+}
@@ -0,0 +1,49 @@
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include <QString>
+#include <QStringList>
+#include <QDate>
+#include <QTextStream>
+
+class QCoreApplication;
+class QCommandLineParser;
+class DatabaseManager;
+
+// Пакетный режим без графического интерфейса (cron, сервер без дисплея):
+//   Organization --batch fines
+//   Organization --batch export --file data.json [--section cars|rentals|users|fines]
+//   Organization --batch import --file data.json [--section ...] [--batch-size N] [--overwrite]
+//   Organization --batch report [--from yyyy-MM-dd] [--to yyyy-MM-dd] [--file report.json]
+// Итог и длительность выполнения выводятся в stdout, ошибки - в stderr
+class BatchRunner
+{
+public:
+    // Код завершения процесса
+    enum ExitCode {
+        Success = 0,
+        Failed = 1,
+        UsageError = 2
+    };
+
+    // Запрошен ли пакетный режим (проверяется до создания QApplication)
+    static bool isBatchInvocation(int argc, char* argv[]);
+
+    BatchRunner();
+
+    int run(const QCoreApplication& app);
+
+private:
+    QTextStream m_out;
+    QTextStream m_err;
+    DatabaseManager* m_dbManager;
+
+    int runFines();
+    int runExport(const QString& filePath, const QString& section);
+    int runImport(const QString& filePath, const QString& section, int batchSize, bool skipExisting);
+    int runReport(const QDate& startDate, const QDate& endDate, const QString& filePath);
+
+    static QDate parseDate(const QString& value, const QDate& fallback, bool* ok);
+};
+
+#endif // BATCHRUNNER_H
@@ -0,0 +1,69 @@
+#include "asyncdatabase.h"
+#include "../services/rentalsearchservice.h"
+#include <QMutexLocker>
+
+AsyncDatabase& AsyncDatabase::getInstance()
+{
+    static AsyncDatabase instance;
+    return instance;
+}
+
+AsyncDatabase::AsyncDatabase()
+{
+    // Потоки не завершаются по таймауту: соединение потока живет вместе с ним,
+    // и повторно открывать его на каждый запрос дороже, чем держать
+    m_threadPool.setMaxThreadCount(DatabaseManager::getInstance().getConnectionPool().getMaxLeases());
+    m_threadPool.setExpiryTimeout(-1);
+}
+
+AsyncDatabase::~AsyncDatabase()
+{
+    waitForDone();
+}
+
+QFuture<QList<Rental>> AsyncDatabase::searchRentals(const QString& channel,
+                                                    const RentalSearchCriteria& criteria)
+{
+    return run<QList<Rental>>(channel, [criteria]() {
+        // Сервис создается в рабочем потоке: его запросы идут через соединение этого потока
+        RentalSearchService searchService;
+        return searchService.searchRentals(criteria);
+    });
+}
+
+QFuture<RentalPage> AsyncDatabase::searchRentalsPage(const QString& channel,
+                                                     const RentalSearchCriteria& criteria,
+                                                     const RentalPageCursor& cursor,
+                                                     int pageSize)
+{
+    return run<RentalPage>(channel, [criteria, cursor, pageSize]() {
+        RentalSearchService searchService;
+        return searchService.searchRentalsPage(criteria, cursor, pageSize);
+    });
+}
+
+void AsyncDatabase::cancel(const QString& channel)
+{
+    QMutexLocker locker(&m_channelsMutex);
+    QFuture<void> previous = m_channels.take(channel);
+    previous.cancel();
+}
+
+void AsyncDatabase::waitForDone()
+{
+    m_threadPool.waitForDone();
+}
+
+void AsyncDatabase::supersede(const QString& channel, const QFuture<void>& future)
+{
+    if (channel.isEmpty()) {
+        return;
+    }
+    
+    QMutexLocker locker(&m_channelsMutex);
+    QFuture<void> previous = m_channels.value(channel);
+    if (!previous.isFinished()) {
+        previous.cancel();
+    }
+    m_channels.insert(channel, future);
+}
@@ -0,0 +1,107 @@
+#ifndef ASYNCDATABASE_H
+#define ASYNCDATABASE_H
+
+#include <QFuture>
+#include <QFutureInterface>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QMutex>
+#include <QHash>
+#include <QString>
+#include <QList>
+#include <QDate>
+#include <functional>
+#include "databasemanager.h"
+#include "connectionpool.h"
+#include "../models/rental.h"
+
+// Задача для пула потоков БД: выполняет функцию под арендой соединения
+// и публикует результат через QFutureInterface
+template<typename T>
+class DatabaseJob : public QRunnable
+{
+public:
+    explicit DatabaseJob(const std::function<T()>& function)
+        : m_function(function)
+    {
+        setAutoDelete(true);
+    }
+    
+    QFuture<T> start(QThreadPool* pool)
+    {
+        m_interface.setThreadPool(pool);
+        m_interface.setRunnable(this);
+        m_interface.reportStarted();
+        QFuture<T> future = m_interface.future();
+        pool->start(this);
+        return future;
+    }
+    
+    void run() override
+    {
+        // Запрос мог быть вытеснен, пока ждал в очереди - тогда к БД не обращаемся
+        if (!m_interface.isCanceled()) {
+            ConnectionLease lease(DatabaseManager::getInstance().getConnectionPool());
+            T result = m_function();
+            if (!m_interface.isCanceled()) {
+                m_interface.reportResult(result);
+            }
+        }
+        m_interface.reportFinished();
+    }
+
+private:
+    std::function<T()> m_function;
+    QFutureInterface<T> m_interface;
+};
+
+// Асинхронный фасад над DatabaseManager.
+// Запросы выполняются на отдельном пуле потоков БД (у каждого потока свое соединение из ConnectionPool),
+// результат доставляется в GUI через QFuture/QFutureWatcher.
+// Запросы группируются по каналам: новый запрос канала отменяет предыдущий незавершенный,
+// поэтому устаревший результат (например, прошлого поиска) не попадет в таблицу.
+class AsyncDatabase
+{
+public:
+    static AsyncDatabase& getInstance();
+    
+    // Выполнить функцию на пуле потоков БД. Пустой channel - без вытеснения
+    template<typename T>
+    QFuture<T> run(const QString& channel, const std::function<T()>& function)
+    {
+        DatabaseJob<T>* job = new DatabaseJob<T>(function);
+        QFuture<T> future = job->start(&m_threadPool);
+        supersede(channel, QFuture<void>(future));
+        return future;
+    }
+    
+    // Поиск аренд по критериям (пустые критерии - все аренды)
+    QFuture<QList<Rental>> searchRentals(const QString& channel,
+                                         const RentalSearchCriteria& criteria = RentalSearchCriteria());
+    
+    // Страница результатов поиска аренд (см. RentalSearchService::searchRentalsPage)
+    QFuture<RentalPage> searchRentalsPage(const QString& channel,
+                                          const RentalSearchCriteria& criteria,
+                                          const RentalPageCursor& cursor,
+                                          int pageSize);
+    
+    // Отменить незавершенный запрос канала
+    void cancel(const QString& channel);
+    
+    // Дождаться завершения всех запросов
+    void waitForDone();
+
+private:
+    AsyncDatabase();
+    ~AsyncDatabase();
+    AsyncDatabase(const AsyncDatabase&) = delete;
+    AsyncDatabase& operator=(const AsyncDatabase&) = delete;
+    
+    void supersede(const QString& channel, const QFuture<void>& future);
+    
+    QThreadPool m_threadPool;
+    QMutex m_channelsMutex;
+    QHash<QString, QFuture<void>> m_channels;
+};
+
+#endif // ASYNCDATABASE_H
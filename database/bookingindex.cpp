@@ -0,0 +1,158 @@
+#include "bookingindex.h"
+#include <QReadLocker>
+#include <QWriteLocker>
+#include <algorithm>
+
+BookingIndex::BookingIndex()
+{
+}
+
+void BookingIndex::load(const QList<Rental>& activeRentals)
+{
+    QWriteLocker locker(&m_lock);
+    m_byCar.clear();
+    m_carByRental.clear();
+    
+    // Сначала собираем периоды, затем сортируем каждый список один раз
+    for (const Rental& rental : activeRentals) {
+        if (rental.isCompleted() || !rental.getStartDate().isValid() || !rental.getEndDate().isValid()) {
+            continue;
+        }
+        Interval interval = { rental.getStartDate().toJulianDay(), rental.getEndDate().toJulianDay(), rental.getId() };
+        m_byCar[rental.getCarId()].intervals.push_back(interval);
+        m_carByRental.insert(rental.getId(), rental.getCarId());
+    }
+    for (QHash<int, CarBookings>::iterator it = m_byCar.begin(); it != m_byCar.end(); ++it) {
+        std::vector<Interval>& intervals = it.value().intervals;
+        std::sort(intervals.begin(), intervals.end(), [](const Interval& a, const Interval& b) {
+            return a.start < b.start;
+        });
+        rebuildPrefix(it.value(), 0);
+    }
+}
+
+void BookingIndex::clear()
+{
+    QWriteLocker locker(&m_lock);
+    m_byCar.clear();
+    m_carByRental.clear();
+}
+
+void BookingIndex::update(const Rental& rental)
+{
+    QWriteLocker locker(&m_lock);
+    removeLocked(rental.getId());
+    if (!rental.isCompleted() && rental.getStartDate().isValid() && rental.getEndDate().isValid()) {
+        insertLocked(rental);
+    }
+}
+
+void BookingIndex::remove(int rentalId)
+{
+    QWriteLocker locker(&m_lock);
+    removeLocked(rentalId);
+}
+
+bool BookingIndex::hasOverlap(int carId, const QDate& startDate, const QDate& endDate, int excludeRentalId) const
+{
+    QReadLocker locker(&m_lock);
+    QHash<int, CarBookings>::const_iterator it = m_byCar.constFind(carId);
+    if (it == m_byCar.constEnd()) {
+        return false;
+    }
+    return overlaps(it.value(), startDate.toJulianDay(), endDate.toJulianDay(), excludeRentalId);
+}
+
+QList<int> BookingIndex::bookedCars(const QDate& startDate, const QDate& endDate) const
+{
+    QReadLocker locker(&m_lock);
+    QList<int> carIds;
+    qint64 start = startDate.toJulianDay();
+    qint64 end = endDate.toJulianDay();
+    for (QHash<int, CarBookings>::const_iterator it = m_byCar.constBegin(); it != m_byCar.constEnd(); ++it) {
+        if (overlaps(it.value(), start, end, 0)) {
+            carIds.append(it.key());
+        }
+    }
+    return carIds;
+}
+
+int BookingIndex::getBookingCount() const
+{
+    QReadLocker locker(&m_lock);
+    return m_carByRental.size();
+}
+
+void BookingIndex::insertLocked(const Rental& rental)
+{
+    Interval interval = { rental.getStartDate().toJulianDay(), rental.getEndDate().toJulianDay(), rental.getId() };
+    CarBookings& bookings = m_byCar[rental.getCarId()];
+    std::vector<Interval>::iterator pos = std::upper_bound(
+        bookings.intervals.begin(), bookings.intervals.end(), interval.start,
+        [](qint64 start, const Interval& other) { return start < other.start; });
+    size_t index = pos - bookings.intervals.begin();
+    bookings.intervals.insert(pos, interval);
+    rebuildPrefix(bookings, index);
+    m_carByRental.insert(rental.getId(), rental.getCarId());
+}
+
+void BookingIndex::removeLocked(int rentalId)
+{
+    QHash<int, int>::iterator carIt = m_carByRental.find(rentalId);
+    if (carIt == m_carByRental.end()) {
+        return;
+    }
+    int carId = carIt.value();
+    m_carByRental.erase(carIt);
+    
+    QHash<int, CarBookings>::iterator it = m_byCar.find(carId);
+    if (it == m_byCar.end()) {
+        return;
+    }
+    std::vector<Interval>& intervals = it.value().intervals;
+    for (size_t i = 0; i < intervals.size(); ++i) {
+        if (intervals[i].rentalId == rentalId) {
+            intervals.erase(intervals.begin() + i);
+            rebuildPrefix(it.value(), i);
+            break;
+        }
+    }
+    if (intervals.empty()) {
+        m_byCar.erase(it);
+    }
+}
+
+void BookingIndex::rebuildPrefix(CarBookings& bookings, size_t from)
+{
+    const std::vector<Interval>& intervals = bookings.intervals;
+    bookings.prefixMaxEnd.resize(intervals.size());
+    for (size_t i = from; i < intervals.size(); ++i) {
+        qint64 previous = i > 0 ? bookings.prefixMaxEnd[i - 1] : intervals[i].end;
+        bookings.prefixMaxEnd[i] = std::max(previous, intervals[i].end);
+    }
+}
+
+bool BookingIndex::overlaps(const CarBookings& bookings, qint64 start, qint64 end, int excludeRentalId)
+{
+    const std::vector<Interval>& intervals = bookings.intervals;
+    // Кандидаты - периоды, начавшиеся не позже end: intervals[0..count)
+    size_t count = std::upper_bound(intervals.begin(), intervals.end(), end,
+                                    [](qint64 value, const Interval& other) { return value < other.start; })
+                   - intervals.begin();
+    if (count == 0 || bookings.prefixMaxEnd[count - 1] < start) {
+        return false;
+    }
+    if (excludeRentalId <= 0) {
+        return true;
+    }
+    
+    // Исключаемая аренда может быть единственным пересечением - проверяем кандидатов с конца,
+    // пока префиксный максимум еще допускает пересечение
+    for (size_t i = count; i > 0 && bookings.prefixMaxEnd[i - 1] >= start; --i) {
+        const Interval& interval = intervals[i - 1];
+        if (interval.rentalId != excludeRentalId && interval.end >= start) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,62 @@
+#ifndef BOOKINGINDEX_H
+#define BOOKINGINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QDate>
+#include <QReadWriteLock>
+#include <vector>
+#include "../models/rental.h"
+
+// Индекс забронированных периодов активных аренд по автомобилям.
+// Для каждого автомобиля периоды хранятся отсортированными по дате начала вместе с
+// префиксным максимумом дат окончания, поэтому проверка "свободен ли автомобиль в [a, b]"
+// выполняется двоичным поиском за O(log k) без обращения к БД.
+// Индекс поддерживается DatabaseManager при каждом изменении аренды. Потокобезопасен
+class BookingIndex
+{
+public:
+    BookingIndex();
+    
+    // Заменить содержимое активными арендами из БД
+    void load(const QList<Rental>& activeRentals);
+    void clear();
+    
+    // Учесть новое или измененное состояние аренды: завершенная аренда из индекса удаляется
+    void update(const Rental& rental);
+    void remove(int rentalId);
+    
+    // Есть ли у автомобиля активная аренда, пересекающаяся с [startDate, endDate] (границы включительно).
+    // excludeRentalId - не учитывать указанную аренду (проверка при ее изменении)
+    bool hasOverlap(int carId, const QDate& startDate, const QDate& endDate, int excludeRentalId = 0) const;
+    
+    // Автомобили, у которых есть активная аренда, пересекающаяся с периодом
+    QList<int> bookedCars(const QDate& startDate, const QDate& endDate) const;
+    
+    int getBookingCount() const;
+
+private:
+    struct Interval
+    {
+        qint64 start;
+        qint64 end;
+        int rentalId;
+    };
+    
+    struct CarBookings
+    {
+        std::vector<Interval> intervals;    // По возрастанию start
+        std::vector<qint64> prefixMaxEnd;   // prefixMaxEnd[i] = max(end) среди intervals[0..i]
+    };
+    
+    void insertLocked(const Rental& rental);
+    void removeLocked(int rentalId);
+    static void rebuildPrefix(CarBookings& bookings, size_t from);
+    static bool overlaps(const CarBookings& bookings, qint64 start, qint64 end, int excludeRentalId);
+    
+    mutable QReadWriteLock m_lock;
+    QHash<int, CarBookings> m_byCar;
+    QHash<int, int> m_carByRental;
+};
+
+#endif // BOOKINGINDEX_H
@@ -0,0 +1,99 @@
+#include "connectionpool.h"
+#include <QSqlError>
+#include <QDebug>
+
+ConnectionPool::ConnectionPool(int maxLeases)
+    : m_leases(qMax(1, maxLeases)), m_maxLeases(qMax(1, maxLeases)),
+      m_connectionCounter(0), m_openConnections(0)
+{
+}
+
+void ConnectionPool::configure(const QString& databasePath, const DatabaseConfig& config)
+{
+    m_databasePath = databasePath;
+    m_config = config;
+}
+
+ConnectionPool::ThreadConnection::~ThreadConnection()
+{
+    // Вызывается при завершении потока: запросы освобождаются до закрытия соединения,
+    // а объект QSqlDatabase должен выйти из области видимости до removeDatabase
+    qDeleteAll(statements);
+    statements.clear();
+    {
+        QSqlDatabase database = QSqlDatabase::database(name, false);
+        if (database.isOpen()) {
+            database.close();
+        }
+    }
+    QSqlDatabase::removeDatabase(name);
+    if (openCounter) {
+        openCounter->fetchAndAddRelaxed(-1);
+    }
+}
+
+ConnectionPool::ThreadConnection* ConnectionPool::threadData()
+{
+    if (m_connections.hasLocalData()) {
+        return m_connections.localData();
+    }
+    
+    ThreadConnection* data = new ThreadConnection();
+    data->name = QString("car_rental_worker_%1").arg(m_connectionCounter.fetchAndAddRelaxed(1));
+    
+    QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", data->name);
+    database.setDatabaseName(m_databasePath);
+    if (database.open()) {
+        m_config.apply(database);
+        data->openCounter = &m_openConnections;
+        m_openConnections.fetchAndAddRelaxed(1);
+    } else {
+        qDebug() << "Ошибка открытия соединения" << data->name << ":" << database.lastError().text();
+    }
+    
+    m_connections.setLocalData(data);
+    return data;
+}
+
+QSqlDatabase ConnectionPool::threadConnection()
+{
+    return QSqlDatabase::database(threadData()->name, false);
+}
+
+QHash<QString, QSqlQuery*>& ConnectionPool::threadStatements()
+{
+    return threadData()->statements;
+}
+
+void ConnectionPool::finishThreadStatements()
+{
+    if (!m_connections.hasLocalData()) {
+        return;
+    }
+    for (QSqlQuery* query : m_connections.localData()->statements) {
+        query->finish();
+    }
+}
+
+void ConnectionPool::acquireLease()
+{
+    m_leases.acquire();
+}
+
+void ConnectionPool::releaseLease()
+{
+    m_leases.release();
+}
+
+ConnectionLease::ConnectionLease(ConnectionPool& pool)
+    : m_pool(pool)
+{
+    m_pool.acquireLease();
+    m_pool.threadConnection();
+}
+
+ConnectionLease::~ConnectionLease()
+{
+    m_pool.finishThreadStatements();
+    m_pool.releaseLease();
+}
@@ -0,0 +1,82 @@
+#ifndef CONNECTIONPOOL_H
+#define CONNECTIONPOOL_H
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+#include <QHash>
+#include <QThreadStorage>
+#include <QSemaphore>
+#include <QAtomicInt>
+#include "databaseconfig.h"
+
+// Пул соединений SQLite для рабочих потоков.
+// Соединение Qt SQL можно использовать только в потоке, где оно создано, поэтому
+// каждый поток получает собственное именованное соединение к тому же файлу БД (в режиме WAL
+// читатели не блокируют писателя). Соединение и кэш подготовленных запросов потока
+// создаются при первом обращении и закрываются при завершении потока.
+class ConnectionPool
+{
+public:
+    explicit ConnectionPool(int maxLeases);
+    
+    // Путь к БД и профиль PRAGMA для новых соединений
+    void configure(const QString& databasePath, const DatabaseConfig& config);
+    
+    // Соединение текущего потока
+    QSqlDatabase threadConnection();
+    
+    // Кэш подготовленных запросов текущего потока
+    QHash<QString, QSqlQuery*>& threadStatements();
+    
+    // Сбросить незавершенные запросы потока (освобождает снимок чтения WAL)
+    void finishThreadStatements();
+    
+    // Ограничение числа одновременно работающих фоновых потоков (см. ConnectionLease)
+    void acquireLease();
+    void releaseLease();
+    
+    int getMaxLeases() const { return m_maxLeases; }
+    int getOpenConnections() const { return m_openConnections.load(); }
+
+private:
+    struct ThreadConnection
+    {
+        QString name;
+        QHash<QString, QSqlQuery*> statements;
+        QAtomicInt* openCounter;
+        
+        ThreadConnection() : openCounter(nullptr) {}
+        ~ThreadConnection();
+    };
+    
+    ThreadConnection* threadData();
+    
+    QThreadStorage<ThreadConnection*> m_connections;
+    QSemaphore m_leases;
+    int m_maxLeases;
+    QString m_databasePath;
+    DatabaseConfig m_config;
+    QAtomicInt m_connectionCounter;
+    QAtomicInt m_openConnections;
+};
+
+// RAII-аренда соединения для фоновой задачи: ждет свободного места в пуле,
+// открывает соединение потока и при освобождении сбрасывает его незавершенные запросы.
+//   ConnectionLease lease(DatabaseManager::getInstance().getConnectionPool());
+class ConnectionLease
+{
+public:
+    explicit ConnectionLease(ConnectionPool& pool);
+    ~ConnectionLease();
+    
+    QSqlDatabase database() const { return m_pool.threadConnection(); }
+
+private:
+    ConnectionLease(const ConnectionLease&) = delete;
+    ConnectionLease& operator=(const ConnectionLease&) = delete;
+    
+    ConnectionPool& m_pool;
+};
+
+#endif // CONNECTIONPOOL_H
@@ -0,0 +1,131 @@
+#include "databaseconfig.h"
+#include <QSettings>
+#include <QFileInfo>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QVariant>
+#include <QDebug>
+
+namespace {
+
+// Значения PRAGMA нельзя передать через параметры запроса,
+// поэтому строковые настройки допускаются только из фиксированного списка
+QString checkedKeyword(const QString& value, const QStringList& allowed, const QString& fallback, const char* name)
+{
+    QString upper = value.trimmed().toUpper();
+    if (allowed.contains(upper)) {
+        return upper;
+    }
+    qDebug() << "Недопустимое значение настройки" << name << ":" << value << "- используется" << fallback;
+    return fallback;
+}
+
+QString environmentValue(const char* name)
+{
+    return QString::fromLocal8Bit(qgetenv(name));
+}
+
+}
+
+DatabaseConfig::DatabaseConfig()
+    : journalMode("WAL"),
+      synchronous("NORMAL"),
+      cacheSizeKb(16384),
+      mmapSize(64LL * 1024 * 1024),
+      tempStore("MEMORY"),
+      busyTimeoutMs(5000)
+{
+}
+
+DatabaseConfig DatabaseConfig::load(const QString& settingsPath)
+{
+    DatabaseConfig defaults;
+    QString journalMode = defaults.journalMode;
+    QString synchronous = defaults.synchronous;
+    QString tempStore = defaults.tempStore;
+    qint64 cacheSizeKb = defaults.cacheSizeKb;
+    qint64 mmapSize = defaults.mmapSize;
+    qint64 busyTimeoutMs = defaults.busyTimeoutMs;
+    
+    if (QFileInfo::exists(settingsPath)) {
+        QSettings settings(settingsPath, QSettings::IniFormat);
+        journalMode = settings.value("sqlite/journal_mode", journalMode).toString();
+        synchronous = settings.value("sqlite/synchronous", synchronous).toString();
+        cacheSizeKb = settings.value("sqlite/cache_size_kb", cacheSizeKb).toLongLong();
+        mmapSize = settings.value("sqlite/mmap_size", mmapSize).toLongLong();
+        tempStore = settings.value("sqlite/temp_store", tempStore).toString();
+        busyTimeoutMs = settings.value("sqlite/busy_timeout_ms", busyTimeoutMs).toLongLong();
+    }
+    
+    // Переменные окружения имеют приоритет над файлом
+    QString value;
+    bool ok = false;
+    if (!(value = environmentValue("CAR_RENTAL_DB_JOURNAL_MODE")).isEmpty()) {
+        journalMode = value;
+    }
+    if (!(value = environmentValue("CAR_RENTAL_DB_SYNCHRONOUS")).isEmpty()) {
+        synchronous = value;
+    }
+    if (!(value = environmentValue("CAR_RENTAL_DB_TEMP_STORE")).isEmpty()) {
+        tempStore = value;
+    }
+    if (!(value = environmentValue("CAR_RENTAL_DB_CACHE_SIZE_KB")).isEmpty()) {
+        qint64 parsed = value.toLongLong(&ok);
+        if (ok) cacheSizeKb = parsed;
+    }
+    if (!(value = environmentValue("CAR_RENTAL_DB_MMAP_SIZE")).isEmpty()) {
+        qint64 parsed = value.toLongLong(&ok);
+        if (ok) mmapSize = parsed;
+    }
+    if (!(value = environmentValue("CAR_RENTAL_DB_BUSY_TIMEOUT_MS")).isEmpty()) {
+        qint64 parsed = value.toLongLong(&ok);
+        if (ok) busyTimeoutMs = parsed;
+    }
+    
+    DatabaseConfig config;
+    config.journalMode = checkedKeyword(journalMode,
+                                        QStringList() << "WAL" << "DELETE" << "TRUNCATE" << "PERSIST" << "MEMORY" << "OFF",
+                                        defaults.journalMode, "journal_mode");
+    config.synchronous = checkedKeyword(synchronous,
+                                        QStringList() << "OFF" << "NORMAL" << "FULL" << "EXTRA",
+                                        defaults.synchronous, "synchronous");
+    config.tempStore = checkedKeyword(tempStore,
+                                      QStringList() << "DEFAULT" << "FILE" << "MEMORY",
+                                      defaults.tempStore, "temp_store");
+    config.cacheSizeKb = cacheSizeKb > 0 ? static_cast<int>(qMin<qint64>(cacheSizeKb, 1024 * 1024)) : defaults.cacheSizeKb;
+    config.mmapSize = qMax<qint64>(0, mmapSize);
+    config.busyTimeoutMs = static_cast<int>(qBound<qint64>(0, busyTimeoutMs, 600000));
+    return config;
+}
+
+QStringList DatabaseConfig::pragmaStatements() const
+{
+    // busy_timeout идет первым: переключение journal_mode само требует блокировки файла
+    return QStringList()
+        << QString("PRAGMA busy_timeout = %1").arg(busyTimeoutMs)
+        << QString("PRAGMA journal_mode = %1").arg(journalMode)
+        << QString("PRAGMA synchronous = %1").arg(synchronous)
+        << QString("PRAGMA cache_size = -%1").arg(cacheSizeKb)
+        << QString("PRAGMA mmap_size = %1").arg(mmapSize)
+        << QString("PRAGMA temp_store = %1").arg(tempStore);
+}
+
+bool DatabaseConfig::apply(QSqlDatabase& database) const
+{
+    bool ok = true;
+    QSqlQuery query(database);
+    for (const QString& statement : pragmaStatements()) {
+        if (!query.exec(statement)) {
+            qDebug() << "Ошибка применения настройки" << statement << query.lastError().text();
+            ok = false;
+            continue;
+        }
+        // journal_mode возвращает фактический режим: WAL недоступен, например, для БД в памяти
+        if (statement.contains("journal_mode") && query.next() &&
+            query.value(0).toString().toUpper() != journalMode) {
+            qDebug() << "Режим журнала" << journalMode << "не применен, текущий:" << query.value(0).toString();
+        }
+        query.finish();
+    }
+    return ok;
+}
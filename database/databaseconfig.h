@@ -0,0 +1,34 @@
+#ifndef DATABASECONFIG_H
+#define DATABASECONFIG_H
+
+#include <QString>
+#include <QStringList>
+#include <QSqlDatabase>
+
+// Профиль настроек SQLite, применяемых к каждому соединению через PRAGMA.
+// Значения по умолчанию рассчитаны на одного писателя и параллельных читателей (WAL).
+// Порядок загрузки: значения по умолчанию -> файл database.ini рядом с БД -> переменные окружения
+struct DatabaseConfig
+{
+    QString journalMode;   // journal_mode: WAL, DELETE, TRUNCATE, PERSIST, MEMORY, OFF
+    QString synchronous;   // synchronous: OFF, NORMAL, FULL, EXTRA
+    int cacheSizeKb;       // cache_size в КиБ (передается в SQLite отрицательным числом)
+    qint64 mmapSize;       // mmap_size в байтах, 0 - отображение файла в память отключено
+    QString tempStore;     // temp_store: DEFAULT, FILE, MEMORY
+    int busyTimeoutMs;     // busy_timeout: сколько ждать освобождения блокировки
+    
+    DatabaseConfig();
+    
+    // Загрузить профиль из ini-файла (секция [sqlite]) с переопределением из окружения:
+    // CAR_RENTAL_DB_JOURNAL_MODE, CAR_RENTAL_DB_SYNCHRONOUS, CAR_RENTAL_DB_CACHE_SIZE_KB,
+    // CAR_RENTAL_DB_MMAP_SIZE, CAR_RENTAL_DB_TEMP_STORE, CAR_RENTAL_DB_BUSY_TIMEOUT_MS
+    static DatabaseConfig load(const QString& settingsPath);
+    
+    // Применить профиль к открытому соединению
+    bool apply(QSqlDatabase& database) const;
+    
+    // PRAGMA-команды профиля
+    QStringList pragmaStatements() const;
+};
+
+#endif // DATABASECONFIG_H
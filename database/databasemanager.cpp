@@ -1,4 +1,5 @@
 #include "databasemanager.h"
+#include "overduefinestatements.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QDebug>
@@ -6,6 +7,8 @@
 #include <QDir>
 #include <QDate>
 #include <QCoreApplication>
+#include <QThread>
+#include <QMutexLocker>
 
 DatabaseManager& DatabaseManager::getInstance()
 {
@@ -14,19 +17,27 @@ DatabaseManager& DatabaseManager::getInstance()
 }
 
 DatabaseManager::DatabaseManager()
+    : m_ownerThread(QThread::currentThread()),
+      m_pool(QThread::idealThreadCount()),
+      m_statementCacheHits(0), m_statementCacheMisses(0),
+      m_hasRentalSearchIndex(false),
+      m_carCache(ENTITY_CACHE_CAPACITY), m_userCache(ENTITY_CACHE_CAPACITY),
+      m_entityRevision(-1)
 {
     m_database = QSqlDatabase::addDatabase("QSQLITE");
     // Сохраняем базу данных в папке проекта Organization/database/
     QDir appDir(QCoreApplication::applicationDirPath());
-    QString dbPath;
+    QString dbPath = QString::fromLocal8Bit(qgetenv("CAR_RENTAL_DB_DIR"));
     
     // Ищем папку Organization/database относительно исполняемого файла
     // Если запускаем из build папки, поднимаемся на уровень выше
     if (appDir.dirName().contains("build") || appDir.dirName().contains("debug") || appDir.dirName().contains("release")) {
         appDir.cdUp();
     }
-    // Проверяем, есть ли папка Organization
-    if (appDir.exists("Organization")) {
+    // Папка БД может быть задана явно (бенчмарки, отдельная копия данных)
+    if (!dbPath.isEmpty()) {
+        dbPath = QDir(dbPath).absolutePath();
+    } else if (appDir.exists("Organization")) {
         dbPath = appDir.absoluteFilePath("Organization/database");
     } else {
         // Если не нашли, используем текущую директорию
@@ -44,6 +55,11 @@ DatabaseManager::DatabaseManager()
     
     QDir().mkpath(dbPath);
     m_database.setDatabaseName(dbPath + "/car_rental.db");
+    
+    // Настройки SQLite берутся из database.ini рядом с файлом БД (если он есть) и окружения
+    m_settingsPath = dbPath + "/database.ini";
+    m_config = DatabaseConfig::load(m_settingsPath);
+    m_pool.configure(m_database.databaseName(), m_config);
 }
 
 DatabaseManager::~DatabaseManager()
@@ -58,16 +74,43 @@ bool DatabaseManager::initializeDatabase()
         return false;
     }
     
+    // Ошибка отдельной настройки не мешает работе - соединение остается с настройками SQLite по умолчанию
+    m_config.apply(m_database);
+    
     if (!createTables()) {
         qDebug() << "Ошибка создания таблиц";
         return false;
     }
     
+    // Обновляем схему существующей базы до актуальной версии
+    if (!migrateSchema()) {
+        qDebug() << "Ошибка миграции схемы базы данных";
+        return false;
+    }
+    
+    if (!loadUserIdAllocator()) {
+        qDebug() << "Ошибка загрузки распределителя ID пользователей";
+        return false;
+    }
+    
+    if (!ensureRentalSearchIndex()) {
+        qDebug() << "Ошибка создания полнотекстового индекса аренд";
+        return false;
+    }
+    
+    if (!loadBookingIndex()) {
+        qDebug() << "Ошибка загрузки индекса активных аренд";
+        return false;
+    }
+    
     return true;
 }
 
 void DatabaseManager::closeDatabase()
 {
+    // Подготовленные запросы привязаны к соединению - освобождаем их до закрытия
+    clearStatementCache();
+    
     if (m_database.isOpen()) {
         m_database.close();
     }
@@ -78,6 +121,111 @@ bool DatabaseManager::isOpen() const
     return m_database.isOpen();
 }
 
+QSqlDatabase DatabaseManager::currentConnection()
+{
+    return isOwnerThread() ? m_database : m_pool.threadConnection();
+}
+
+QHash<QString, QSqlQuery*>& DatabaseManager::currentStatementCache()
+{
+    return isOwnerThread() ? m_statementCache : m_pool.threadStatements();
+}
+
+QSqlQuery& DatabaseManager::cachedQuery(const QString& sql)
+{
+    QHash<QString, QSqlQuery*>& cache = currentStatementCache();
+    QSqlQuery* query = cache.value(sql, nullptr);
+    if (query) {
+        m_statementCacheHits.fetchAndAddRelaxed(1);
+        return *query;
+    }
+    
+    m_statementCacheMisses.fetchAndAddRelaxed(1);
+    query = new QSqlQuery(currentConnection());
+    // Все выборки читаются один раз от начала до конца - курсор без буферизации
+    query->setForwardOnly(true);
+    if (!query->prepare(sql)) {
+        qDebug() << "Ошибка подготовки запроса:" << query->lastError().text() << sql;
+        // Неподготовленный запрос не кэшируется под своим текстом: следующий вызов снова выполнит prepare.
+        // Вызывающему возвращается запрос потока для ошибок (ключ - пустая строка), его exec() завершится
+        // ошибкой. Он не удаляется до очистки кэша, поэтому ссылки на него остаются действительными
+        QSqlQuery* failed = cache.value(QString(), nullptr);
+        if (failed) {
+            delete query;
+            failed->prepare(sql);
+            return *failed;
+        }
+        cache.insert(QString(), query);
+        return *query;
+    }
+    cache.insert(sql, query);
+    return *query;
+}
+
+int DatabaseManager::tableSizeHint(const QString& table)
+{
+    // MAX(rowid) берется из B-дерева за O(log n) и дает верхнюю оценку числа строк.
+    // После удалений или импорта с большими ID оценка может быть сколь угодно завышена,
+    // поэтому резерв ограничен TABLE_SIZE_HINT_LIMIT - дальше список растет сам
+    QSqlQuery& query = cachedQuery(QString("SELECT MAX(rowid) FROM %1").arg(table));
+    qint64 hint = 0;
+    if (query.exec() && query.next()) {
+        hint = query.value(0).toLongLong();
+    }
+    query.finish();
+    return static_cast<int>(qBound<qint64>(0, hint, TABLE_SIZE_HINT_LIMIT));
+}
+
+template<typename T>
+bool DatabaseManager::forEachRow(const RowFilter& filter, const std::function<bool(const T&)>& callback)
+{
+    // Отдельный (не кэшированный) запрос: callback может сам обращаться к БД,
+    // в том числе к тем же подготовленным запросам, не сбивая курсор обхода
+    QSqlQuery query(currentConnection());
+    query.setForwardOnly(true);
+    QString sql = selectSql<T>(filter.condition.isEmpty() ? QString() : "WHERE " + filter.condition);
+    if (!query.prepare(sql)) {
+        qDebug() << "Ошибка подготовки запроса:" << query.lastError().text() << sql;
+        return false;
+    }
+    for (const QVariant& value : filter.bindValues) {
+        query.addBindValue(value);
+    }
+    if (!query.exec()) {
+        qDebug() << "Ошибка выполнения запроса:" << query.lastError().text();
+        return false;
+    }
+    
+    visitRows<T>(query, callback);
+    return true;
+}
+
+bool DatabaseManager::forEachUser(const RowFilter& filter, const std::function<bool(const User&)>& callback)
+{
+    return forEachRow<User>(filter, callback);
+}
+
+bool DatabaseManager::forEachCar(const RowFilter& filter, const std::function<bool(const Car&)>& callback)
+{
+    return forEachRow<Car>(filter, callback);
+}
+
+bool DatabaseManager::forEachRental(const RowFilter& filter, const std::function<bool(const Rental&)>& callback)
+{
+    return forEachRow<Rental>(filter, callback);
+}
+
+bool DatabaseManager::forEachFine(const RowFilter& filter, const std::function<bool(const Fine&)>& callback)
+{
+    return forEachRow<Fine>(filter, callback);
+}
+
+void DatabaseManager::clearStatementCache()
+{
+    qDeleteAll(m_statementCache);
+    m_statementCache.clear();
+}
+
 bool DatabaseManager::createTables()
 {
     QSqlQuery query(m_database);
@@ -128,102 +276,519 @@ bool DatabaseManager::createTables()
     return true;
 }
 
+int DatabaseManager::getSchemaVersion()
+{
+    QSqlQuery query("PRAGMA user_version", currentConnection());
+    if (query.next()) {
+        return query.value(0).toInt();
+    }
+    return 0;
+}
+
+bool DatabaseManager::beginTransaction()
+{
+    QSqlDatabase database = currentConnection();
+    if (!database.transaction()) {
+        qDebug() << "Не удалось начать транзакцию:" << database.lastError().text();
+        return false;
+    }
+    enterTransaction();
+    return true;
+}
+
+bool DatabaseManager::commitTransaction()
+{
+    QSqlDatabase database = currentConnection();
+    if (!database.commit()) {
+        qDebug() << "Не удалось зафиксировать транзакцию:" << database.lastError().text();
+        return false;
+    }
+    leaveTransaction(true);
+    return true;
+}
+
+bool DatabaseManager::rollbackTransaction()
+{
+    // Индекс аренд и распределитель ID пользователей могли получить изменения,
+    // которые откатываются вместе с транзакцией
+    bool ok = currentConnection().rollback();
+    leaveTransaction(false);
+    loadBookingIndex();
+    loadUserIdAllocator();
+    return ok;
+}
+
+bool DatabaseManager::beginSavepoint(const QString& name)
+{
+    QSqlQuery& query = cachedQuery(QString("SAVEPOINT %1").arg(name));
+    if (!query.exec()) {
+        qDebug() << "Не удалось создать точку сохранения" << name << query.lastError().text();
+        return false;
+    }
+    enterTransaction();
+    return true;
+}
+
+bool DatabaseManager::releaseSavepoint(const QString& name)
+{
+    QSqlQuery& query = cachedQuery(QString("RELEASE %1").arg(name));
+    if (!query.exec()) {
+        qDebug() << "Не удалось зафиксировать точку сохранения" << name << query.lastError().text();
+        return false;
+    }
+    leaveTransaction();
+    return true;
+}
+
+void DatabaseManager::rollbackToSavepoint(const QString& name)
+{
+    // ROLLBACK TO оставляет точку сохранения открытой - RELEASE снимает ее
+    // (и завершает транзакцию, если точка сохранения ее начала)
+    QSqlQuery& rollback = cachedQuery(QString("ROLLBACK TO %1").arg(name));
+    if (!rollback.exec()) {
+        qDebug() << "Не удалось откатить точку сохранения" << name << rollback.lastError().text();
+    }
+    cachedQuery(QString("RELEASE %1").arg(name)).exec();
+    leaveTransaction();
+}
+
+DatabaseManager::TransactionState& DatabaseManager::currentTransaction()
+{
+    if (!m_transactions.hasLocalData()) {
+        m_transactions.setLocalData(new TransactionState());
+    }
+    return *m_transactions.localData();
+}
+
+bool DatabaseManager::inTransaction()
+{
+    return currentTransaction().depth > 0;
+}
+
+void DatabaseManager::enterTransaction()
+{
+    currentTransaction().depth++;
+}
+
+void DatabaseManager::leaveTransaction(bool all)
+{
+    TransactionState& transaction = currentTransaction();
+    transaction.depth = all ? 0 : qMax(0, transaction.depth - 1);
+    if (transaction.depth > 0) {
+        return;
+    }
+    // Транзакция завершена. Записи, измененные в ней, удаляются из кэша еще раз: поток, прочитавший
+    // до фиксации прежнюю строку, не сможет положить ее в кэш - поколение уже изменилось
+    for (int carId : transaction.carIds) {
+        m_carCache.remove(carId);
+    }
+    for (int userId : transaction.userIds) {
+        m_userCache.remove(userId);
+    }
+    transaction.carIds.clear();
+    transaction.userIds.clear();
+}
+
+void DatabaseManager::checkEntityRevision()
+{
+    {
+        QMutexLocker locker(&m_entityRevisionMutex);
+        if (m_entityRevisionTimer.isValid() && m_entityRevisionTimer.elapsed() < ENTITY_REVISION_CHECK_MS) {
+            return;
+        }
+        m_entityRevisionTimer.start();
+    }
+    
+    int revision = getMaintenanceValue("entities_revision", -1);
+    if (m_entityRevision.fetchAndStoreOrdered(revision) != revision) {
+        m_carCache.clear();
+        m_userCache.clear();
+    }
+}
+
+void DatabaseManager::storeCachedCar(const Car& car, quint64 generation)
+{
+    if (inTransaction()) {
+        // До фиксации строка видна только этому соединению
+        m_carCache.remove(car.getId());
+        currentTransaction().carIds.insert(car.getId());
+    } else {
+        m_carCache.publish(car.getId(), car, generation);
+    }
+}
+
+void DatabaseManager::storeCachedUser(const User& user, quint64 generation)
+{
+    if (inTransaction()) {
+        m_userCache.remove(user.getId());
+        currentTransaction().userIds.insert(user.getId());
+    } else {
+        m_userCache.publish(user.getId(), user, generation);
+    }
+}
+
+void DatabaseManager::invalidateCachedCar(int carId)
+{
+    m_carCache.remove(carId);
+    if (inTransaction()) {
+        currentTransaction().carIds.insert(carId);
+    }
+}
+
+void DatabaseManager::invalidateCachedUser(int userId)
+{
+    m_userCache.remove(userId);
+    if (inTransaction()) {
+        currentTransaction().userIds.insert(userId);
+    }
+}
+
+bool DatabaseManager::migrateSchema()
+{
+    int version = getSchemaVersion();
+    if (version > SCHEMA_VERSION) {
+        qDebug() << "База данных создана более новой версией приложения, версия схемы:" << version;
+        return true;
+    }
+    
+    // Каждая миграция выполняется в своей транзакции вместе с обновлением user_version,
+    // поэтому прерванное обновление не оставляет схему в промежуточном состоянии
+    while (version < SCHEMA_VERSION) {
+        int target = version + 1;
+        if (!m_database.transaction()) {
+            qDebug() << "Не удалось начать транзакцию миграции:" << m_database.lastError().text();
+            return false;
+        }
+        
+        QSqlQuery query(m_database);
+        if (!applyMigration(target) ||
+            !query.exec(QString("PRAGMA user_version = %1").arg(target))) {
+            qDebug() << "Ошибка миграции схемы до версии" << target << query.lastError().text();
+            m_database.rollback();
+            return false;
+        }
+        
+        if (!m_database.commit()) {
+            qDebug() << "Не удалось зафиксировать миграцию:" << m_database.lastError().text();
+            m_database.rollback();
+            return false;
+        }
+        
+        qDebug() << "Схема базы данных обновлена до версии" << target;
+        version = target;
+    }
+    
+    return true;
+}
+
+bool DatabaseManager::applyMigration(int version)
+{
+    switch (version) {
+    case 1:
+        // Вторичные индексы для поиска аренд и штрафов
+        return execStatements(QStringList()
+            << "CREATE INDEX IF NOT EXISTS idx_rentals_car_dates ON rentals(car_id, start_date, end_date)"
+            << "CREATE INDEX IF NOT EXISTS idx_rentals_user_id ON rentals(user_id)"
+            << "CREATE INDEX IF NOT EXISTS idx_rentals_is_completed ON rentals(is_completed)"
+            << "CREATE INDEX IF NOT EXISTS idx_fines_rental_id ON fines(rental_id)"
+            << "CREATE INDEX IF NOT EXISTS idx_fines_date ON fines(date)"
+            << "CREATE INDEX IF NOT EXISTS idx_cars_status ON cars(status)");
+    case 2:
+        // Перевод дат из текста 'yyyy-MM-dd' в номер юлианского дня.
+        // julianday() отсчитывает сутки от полудня, поэтому +0.5 дает значение QDate::toJulianDay()
+        return execStatements(QStringList()
+            << "UPDATE rentals SET start_date = CAST(julianday(start_date) + 0.5 AS INTEGER) "
+               "WHERE typeof(start_date) = 'text' AND julianday(start_date) IS NOT NULL"
+            << "UPDATE rentals SET end_date = CAST(julianday(end_date) + 0.5 AS INTEGER) "
+               "WHERE typeof(end_date) = 'text' AND julianday(end_date) IS NOT NULL"
+            << "UPDATE rentals SET actual_return_date = CAST(julianday(actual_return_date) + 0.5 AS INTEGER) "
+               "WHERE typeof(actual_return_date) = 'text' AND julianday(actual_return_date) IS NOT NULL"
+            << "UPDATE fines SET date = CAST(julianday(date) + 0.5 AS INTEGER) "
+               "WHERE typeof(date) = 'text' AND julianday(date) IS NOT NULL");
+    case 3:
+        // Распределитель ID пользователей: список свободных ID ниже границы и сама граница.
+        // Дыры между 1 и максимальным ID заполняются рекурсивным CTE
+        return execStatements(QStringList()
+            << "CREATE TABLE IF NOT EXISTS user_id_holes (id INTEGER PRIMARY KEY)"
+            << "CREATE TABLE IF NOT EXISTS id_allocator ("
+               "name TEXT PRIMARY KEY,"
+               "high_water INTEGER NOT NULL)"
+            << "INSERT OR REPLACE INTO id_allocator (name, high_water) "
+               "SELECT 'users', COALESCE(MAX(id), 0) + 1 FROM users"
+            << "WITH RECURSIVE seq(id) AS ("
+               "SELECT 1 WHERE EXISTS (SELECT 1 FROM users) "
+               "UNION ALL SELECT id + 1 FROM seq WHERE id < (SELECT MAX(id) FROM users)) "
+               "INSERT OR IGNORE INTO user_id_holes (id) "
+               "SELECT id FROM seq WHERE id NOT IN (SELECT id FROM users)");
+    case 4:
+        // Префиксный поиск автомобилей по марке и модели без учета регистра
+        return execStatements(QStringList()
+            << "CREATE INDEX IF NOT EXISTS idx_cars_brand_model_nocase ON cars(brand COLLATE NOCASE, model COLLATE NOCASE)"
+            << "CREATE INDEX IF NOT EXISTS idx_cars_model_nocase ON cars(model COLLATE NOCASE)");
+    case 5:
+        // Постраничный вывод аренд от новых к старым (keyset по start_date, id)
+        return execStatements(QStringList()
+            << "CREATE INDEX IF NOT EXISTS idx_rentals_start_date_id ON rentals(start_date, id)");
+    case 6:
+        // Служебное состояние фоновых задач. rentals_revision увеличивается триггерами при любом
+        // изменении входных данных расчета штрафов (аренды, штрафы, цены автомобилей),
+        // overdue_sweep_* - отметка последнего пересчета штрафов за просрочку
+        return execStatements(QStringList()
+            << "CREATE TABLE IF NOT EXISTS maintenance_state ("
+               "name TEXT PRIMARY KEY,"
+               "int_value INTEGER NOT NULL DEFAULT 0)"
+            << "INSERT OR IGNORE INTO maintenance_state (name, int_value) VALUES "
+               "('rentals_revision', 0), ('overdue_sweep_day', 0), ('overdue_sweep_revision', -1)"
+            << "CREATE TRIGGER IF NOT EXISTS trg_rentals_revision_insert AFTER INSERT ON rentals BEGIN "
+               "UPDATE maintenance_state SET int_value = int_value + 1 WHERE name = 'rentals_revision'; END"
+            << "CREATE TRIGGER IF NOT EXISTS trg_rentals_revision_update AFTER UPDATE ON rentals BEGIN "
+               "UPDATE maintenance_state SET int_value = int_value + 1 WHERE name = 'rentals_revision'; END"
+            << "CREATE TRIGGER IF NOT EXISTS trg_rentals_revision_delete AFTER DELETE ON rentals BEGIN "
+               "UPDATE maintenance_state SET int_value = int_value + 1 WHERE name = 'rentals_revision'; END"
+            << "CREATE TRIGGER IF NOT EXISTS trg_fines_revision_insert AFTER INSERT ON fines BEGIN "
+               "UPDATE maintenance_state SET int_value = int_value + 1 WHERE name = 'rentals_revision'; END"
+            << "CREATE TRIGGER IF NOT EXISTS trg_fines_revision_update AFTER UPDATE ON fines BEGIN "
+               "UPDATE maintenance_state SET int_value = int_value + 1 WHERE name = 'rentals_revision'; END"
+            << "CREATE TRIGGER IF NOT EXISTS trg_fines_revision_delete AFTER DELETE ON fines BEGIN "
+               "UPDATE maintenance_state SET int_value = int_value + 1 WHERE name = 'rentals_revision'; END"
+            << "CREATE TRIGGER IF NOT EXISTS trg_cars_revision_price AFTER UPDATE OF daily_price ON cars BEGIN "
+               "UPDATE maintenance_state SET int_value = int_value + 1 WHERE name = 'rentals_revision'; END");
+    case 7: {
+        // Ревизия данных отчетов: заранее рассчитанный отчет действителен, пока она не изменилась
+        QStringList statements;
+        statements << "INSERT OR IGNORE INTO maintenance_state (name, int_value) VALUES ('reports_revision', 0)";
+        for (const QString& table : QStringList() << "rentals" << "fines" << "cars") {
+            for (const QString& event : QStringList() << "INSERT" << "UPDATE" << "DELETE") {
+                statements << QString("CREATE TRIGGER IF NOT EXISTS trg_%1_reports_%2 AFTER %3 ON %1 BEGIN "
+                                      "UPDATE maintenance_state SET int_value = int_value + 1 "
+                                      "WHERE name = 'reports_revision'; END").arg(table, event.toLower(), event);
+            }
+        }
+        return execStatements(statements);
+    }
+    case 8: {
+        // Ревизия автомобилей и пользователей: по ней кэш по ID узнает об изменениях других процессов
+        QStringList statements;
+        statements << "INSERT OR IGNORE INTO maintenance_state (name, int_value) VALUES ('entities_revision', 0)";
+        for (const QString& table : QStringList() << "cars" << "users") {
+            for (const QString& event : QStringList() << "INSERT" << "UPDATE" << "DELETE") {
+                statements << QString("CREATE TRIGGER IF NOT EXISTS trg_%1_entities_%2 AFTER %3 ON %1 BEGIN "
+                                      "UPDATE maintenance_state SET int_value = int_value + 1 "
+                                      "WHERE name = 'entities_revision'; END").arg(table, event.toLower(), event);
+            }
+        }
+        return execStatements(statements);
+    }
+    default:
+        qDebug() << "Неизвестная версия миграции:" << version;
+        return false;
+    }
+}
+
+bool DatabaseManager::execStatements(const QStringList& statements)
+{
+    QSqlQuery query(currentConnection());
+    for (const QString& sql : statements) {
+        if (!query.exec(sql)) {
+            qDebug() << "Ошибка выполнения:" << sql << query.lastError().text();
+            return false;
+        }
+    }
+    return true;
+}
+
 // User operations
 bool DatabaseManager::addUser(const User& user)
 {
-    QSqlQuery query(m_database);
-    int newId = getNextAvailableUserId();
-    query.prepare("INSERT INTO users (id, username, password, full_name, role) "
-                 "VALUES (?, ?, ?, ?, ?)");
-    query.addBindValue(newId);
-    query.addBindValue(user.getUsername());
-    query.addBindValue(user.getPassword());
-    query.addBindValue(user.getFullName());
-    query.addBindValue(static_cast<int>(user.getRole()));
-    return query.exec();
+    // Запись распределителя (user_id_holes, id_allocator) и вставка пользователя - в одной точке
+    // сохранения: при ошибке обе отменяются, а внутри транзакции импорта откатывается только эта запись.
+    // Повтор нужен, если ID занят строкой, вставленной другим процессом (пакетный импорт рядом с GUI)
+    for (int attempt = 0; attempt < USER_ID_CONFLICT_RETRIES; ++attempt) {
+        const quint64 generation = m_userCache.getGeneration();
+        if (!beginSavepoint("add_user")) {
+            return false;
+        }
+        
+        int newId = 0;
+        bool ok = allocateUserId(&newId);
+        if (ok) {
+            QSqlQuery& query = cachedQuery("INSERT INTO users (id, username, password, full_name, role) "
+                                           "VALUES (?, ?, ?, ?, ?)");
+            query.addBindValue(newId);
+            query.addBindValue(user.getUsername());
+            query.addBindValue(user.getPassword());
+            query.addBindValue(user.getFullName());
+            query.addBindValue(static_cast<int>(user.getRole()));
+            ok = query.exec();
+        }
+        if (ok && releaseSavepoint("add_user")) {
+            User stored = user;
+            stored.setId(newId);
+            storeCachedUser(stored, generation);
+            return true;
+        }
+        
+        // Распределитель в БД откатился вместе со вставкой - состояние в памяти перечитывается из нее
+        rollbackToSavepoint("add_user");
+        bool conflict = newId > 0 && userIdExists(newId);
+        if (!loadUserIdAllocator() || !conflict) {
+            // Например, логин уже занят
+            return false;
+        }
+        qDebug() << "ID пользователя" << newId << "уже занят, распределитель перечитан";
+    }
+    return false;
+}
+
+bool DatabaseManager::userIdExists(int userId)
+{
+    QSqlQuery& query = cachedQuery("SELECT 1 FROM users WHERE id=?");
+    query.addBindValue(userId);
+    bool exists = query.exec() && query.next();
+    query.finish();
+    return exists;
 }
 
 bool DatabaseManager::updateUser(const User& user)
 {
-    QSqlQuery query(m_database);
-    query.prepare("UPDATE users SET username=?, password=?, full_name=?, role=? WHERE id=?");
+    const quint64 generation = m_userCache.getGeneration();
+    QSqlQuery& query = cachedQuery("UPDATE users SET username=?, password=?, full_name=?, role=? WHERE id=?");
     query.addBindValue(user.getUsername());
     query.addBindValue(user.getPassword());
     query.addBindValue(user.getFullName());
     query.addBindValue(static_cast<int>(user.getRole()));
     query.addBindValue(user.getId());
-    return query.exec();
+    if (!query.exec()) {
+        // Состояние строки неизвестно - следующее чтение возьмет ее из БД
+        invalidateCachedUser(user.getId());
+        return false;
+    }
+    
+    if (query.numRowsAffected() > 0) {
+        storeCachedUser(user, generation);
+    }
+    return true;
 }
 
 bool DatabaseManager::deleteUser(int userId)
 {
-    QSqlQuery query(m_database);
-    query.prepare("DELETE FROM users WHERE id=?");
+    // Удаление и возврат ID в список свободных - одной точкой сохранения
+    if (!beginSavepoint("delete_user")) {
+        return false;
+    }
+    invalidateCachedUser(userId);
+    QSqlQuery& query = cachedQuery("DELETE FROM users WHERE id=?");
     query.addBindValue(userId);
-    return query.exec();
+    bool ok = query.exec();
+    if (ok && query.numRowsAffected() > 0) {
+        ok = releaseUserId(userId);
+    }
+    if (!ok || !releaseSavepoint("delete_user")) {
+        rollbackToSavepoint("delete_user");
+        loadUserIdAllocator();
+        return false;
+    }
+    return true;
 }
 
 User DatabaseManager::getUserById(int userId)
 {
-    QSqlQuery query(m_database);
-    query.prepare("SELECT * FROM users WHERE id=?");
-    query.addBindValue(userId);
-    query.exec();
+    checkEntityRevision();
+    User user;
+    if (m_userCache.find(userId, &user)) {
+        return user;
+    }
     
-    if (query.next()) {
-        return User(query.value(0).toInt(),
-                   query.value(1).toString(),
-                   query.value(2).toString(),
-                   query.value(3).toString(),
-                   static_cast<UserRole>(query.value(4).toInt()));
+    // Поколение берется до чтения: если строку за это время изменили, прочитанное значение не кэшируется
+    const quint64 generation = m_userCache.getGeneration();
+    static const QString sql = selectSql<User>("WHERE id=?");
+    QSqlQuery& query = cachedQuery(sql);
+    query.addBindValue(userId);
+    user = fetchOne<User>(query);
+    // Внутри транзакции строка может быть еще не зафиксирована - в общий кэш не попадает
+    if (user.getId() > 0 && !inTransaction()) {
+        m_userCache.fill(user.getId(), user, generation);
     }
-    return User();
+    return user;
 }
 
 User DatabaseManager::getUserByUsername(const QString& username)
 {
-    QSqlQuery query(m_database);
-    query.prepare("SELECT * FROM users WHERE username=?");
+    const quint64 generation = m_userCache.getGeneration();
+    static const QString sql = selectSql<User>("WHERE username=?");
+    QSqlQuery& query = cachedQuery(sql);
     query.addBindValue(username);
-    query.exec();
-    
-    if (query.next()) {
-        return User(query.value(0).toInt(),
-                   query.value(1).toString(),
-                   query.value(2).toString(),
-                   query.value(3).toString(),
-                   static_cast<UserRole>(query.value(4).toInt()));
+    User user = fetchOne<User>(query);
+    if (user.getId() > 0 && !inTransaction()) {
+        m_userCache.fill(user.getId(), user, generation);
     }
-    return User();
+    return user;
 }
 
 QList<User> DatabaseManager::getAllUsers()
 {
-    QList<User> users;
-    QSqlQuery query("SELECT * FROM users ORDER BY id ASC", m_database);
+    static const QString sql = selectSql<User>("ORDER BY id ASC");
+    return fetchAll<User>(cachedQuery(sql), tableSizeHint("users"));
+}
+
+bool DatabaseManager::loadUserIdAllocator()
+{
+    // Сверка с таблицей users на случай прерванной работы: ID, выделенный, но не сохраненный,
+    // или граница, записанная не по порядку из разных потоков
+    if (!execStatements(QStringList()
+            << "DELETE FROM user_id_holes WHERE id IN (SELECT id FROM users)"
+            << "UPDATE id_allocator SET high_water = MAX(high_water, "
+               "(SELECT COALESCE(MAX(id), 0) + 1 FROM users)) WHERE name = 'users'"
+            << "DELETE FROM user_id_holes WHERE id >= "
+               "(SELECT high_water FROM id_allocator WHERE name = 'users')")) {
+        return false;
+    }
     
+    QSqlQuery query(currentConnection());
+    query.setForwardOnly(true);
+    int highWater = 1;
+    if (query.exec("SELECT high_water FROM id_allocator WHERE name = 'users'") && query.next()) {
+        highWater = query.value(0).toInt();
+    }
+    
+    QList<int> holes;
+    if (!query.exec("SELECT id FROM user_id_holes ORDER BY id")) {
+        qDebug() << "Ошибка загрузки свободных ID пользователей:" << query.lastError().text();
+        return false;
+    }
     while (query.next()) {
-        users.append(User(query.value(0).toInt(),
-                         query.value(1).toString(),
-                         query.value(2).toString(),
-                         query.value(3).toString(),
-                         static_cast<UserRole>(query.value(4).toInt())));
+        holes.append(query.value(0).toInt());
     }
-    return users;
+    
+    m_userIds.load(holes, highWater);
+    return true;
 }
 
-int DatabaseManager::getNextAvailableUserId()
+bool DatabaseManager::allocateUserId(int* userId)
 {
-    QSqlQuery query(m_database);
-    // Находим первую свободную "дыру" или следующий после максимального
-    query.exec("SELECT COALESCE((SELECT MIN(t.id)+1 FROM users t "
-               "WHERE NOT EXISTS (SELECT 1 FROM users t2 WHERE t2.id = t.id + 1)), 1)");
-    if (query.next()) {
-        int candidate = query.value(0).toInt();
-        if (candidate <= 0) candidate = 1;
-        return candidate;
+    bool fromHole = false;
+    *userId = m_userIds.reserve(&fromHole);
+    
+    if (fromHole) {
+        QSqlQuery& query = cachedQuery("DELETE FROM user_id_holes WHERE id=?");
+        query.addBindValue(*userId);
+        return query.exec();
     }
-    return 1;
+    // MAX: при параллельном выделении границы записываются в произвольном порядке
+    QSqlQuery& query = cachedQuery("UPDATE id_allocator SET high_water = MAX(high_water, ?) WHERE name = 'users'");
+    query.addBindValue(*userId + 1);
+    return query.exec();
+}
+
+bool DatabaseManager::releaseUserId(int userId)
+{
+    QSqlQuery& query = cachedQuery("INSERT OR IGNORE INTO user_id_holes (id) VALUES (?)");
+    query.addBindValue(userId);
+    if (!query.exec()) {
+        return false;
+    }
+    m_userIds.release(userId);
+    return true;
 }
 
 bool DatabaseManager::authenticateUser(const QString& username, const QString& password)
@@ -235,289 +800,441 @@ bool DatabaseManager::authenticateUser(const QString& username, const QString& p
 // Car operations
 bool DatabaseManager::addCar(const Car& car)
 {
-    QSqlQuery query(m_database);
-    query.prepare("INSERT INTO cars (brand, model, status, daily_price) "
-                 "VALUES (?, ?, ?, ?)");
+    const quint64 generation = m_carCache.getGeneration();
+    QSqlQuery& query = cachedQuery("INSERT INTO cars (brand, model, status, daily_price) "
+                                   "VALUES (?, ?, ?, ?)");
     query.addBindValue(car.getBrand());
     query.addBindValue(car.getModel());
     query.addBindValue(static_cast<int>(car.getStatus()));
     query.addBindValue(car.getDailyPrice());
-    return query.exec();
+    if (!query.exec()) {
+        return false;
+    }
+    
+    int newId = query.lastInsertId().toInt();
+    if (newId > 0) {
+        Car stored = car;
+        stored.setId(newId);
+        storeCachedCar(stored, generation);
+    }
+    return true;
 }
 
 bool DatabaseManager::updateCar(const Car& car)
 {
-    QSqlQuery query(m_database);
-    query.prepare("UPDATE cars SET brand=?, model=?, status=?, daily_price=? WHERE id=?");
+    const quint64 generation = m_carCache.getGeneration();
+    QSqlQuery& query = cachedQuery("UPDATE cars SET brand=?, model=?, status=?, daily_price=? WHERE id=?");
     query.addBindValue(car.getBrand());
     query.addBindValue(car.getModel());
     query.addBindValue(static_cast<int>(car.getStatus()));
     query.addBindValue(car.getDailyPrice());
     query.addBindValue(car.getId());
-    return query.exec();
+    if (!query.exec()) {
+        // Состояние строки неизвестно - следующее чтение возьмет ее из БД
+        invalidateCachedCar(car.getId());
+        return false;
+    }
+    
+    if (query.numRowsAffected() > 0) {
+        storeCachedCar(car, generation);
+    }
+    return true;
+}
+
+bool DatabaseManager::updateCarStatus(int carId, CarStatus status)
+{
+    const quint64 generation = m_carCache.getGeneration();
+    QSqlQuery& query = cachedQuery("UPDATE cars SET status=? WHERE id=?");
+    query.addBindValue(static_cast<int>(status));
+    query.addBindValue(carId);
+    if (!query.exec()) {
+        invalidateCachedCar(carId);
+        return false;
+    }
+    updateCachedCarStatus(carId, status, generation);
+    return true;
+}
+
+bool DatabaseManager::updateCarStatuses(const QMap<int, CarStatus>& statuses)
+{
+    if (statuses.isEmpty()) {
+        return true;
+    }
+    
+    // Группировка по целевому статусу: один запрос на статус и часть списка ID
+    QMap<int, QList<int>> idsByStatus;
+    for (auto it = statuses.constBegin(); it != statuses.constEnd(); ++it) {
+        idsByStatus[static_cast<int>(it.value())].append(it.key());
+    }
+    
+    // Точка сохранения, а не BEGIN: пакет может прийти внутри уже открытой транзакции вызывающего
+    const quint64 generation = m_carCache.getGeneration();
+    if (!beginSavepoint("car_statuses")) {
+        return false;
+    }
+    
+    QSqlDatabase database = currentConnection();
+    for (auto group = idsByStatus.constBegin(); group != idsByStatus.constEnd(); ++group) {
+        const QList<int>& carIds = group.value();
+        for (int offset = 0; offset < carIds.size(); offset += CAR_STATUS_CHUNK_SIZE) {
+            QList<int> chunk = carIds.mid(offset, CAR_STATUS_CHUNK_SIZE);
+            QStringList placeholders;
+            for (int i = 0; i < chunk.size(); ++i) {
+                placeholders << "?";
+            }
+            // Полные части повторяют один текст запроса и берутся из кэша подготовленных,
+            // последняя неполная готовится отдельно, чтобы не засорять кэш
+            QString sql = QString("UPDATE cars SET status=? WHERE id IN (%1)").arg(placeholders.join(", "));
+            QSqlQuery partial(database);
+            QSqlQuery* query = &partial;
+            if (chunk.size() == CAR_STATUS_CHUNK_SIZE) {
+                query = &cachedQuery(sql);
+            } else {
+                partial.prepare(sql);
+            }
+            query->addBindValue(group.key());
+            for (int carId : chunk) {
+                query->addBindValue(carId);
+            }
+            if (!query->exec()) {
+                qDebug() << "Ошибка пакетного обновления статусов:" << query->lastError().text();
+                rollbackToSavepoint("car_statuses");
+                return false;
+            }
+        }
+    }
+    
+    if (!releaseSavepoint("car_statuses")) {
+        rollbackToSavepoint("car_statuses");
+        return false;
+    }
+    
+    for (auto it = statuses.constBegin(); it != statuses.constEnd(); ++it) {
+        updateCachedCarStatus(it.key(), it.value(), generation);
+    }
+    return true;
+}
+
+void DatabaseManager::updateCachedCarStatus(int carId, CarStatus status, quint64 generation)
+{
+    if (inTransaction()) {
+        invalidateCachedCar(carId);
+        return;
+    }
+    m_carCache.modify(carId, [status](Car& car) { car.setStatus(status); }, generation);
 }
 
 bool DatabaseManager::deleteCar(int carId)
 {
-    QSqlQuery query(m_database);
-    query.prepare("DELETE FROM cars WHERE id=?");
+    QSqlQuery& query = cachedQuery("DELETE FROM cars WHERE id=?");
     query.addBindValue(carId);
-    return query.exec();
+    bool ok = query.exec();
+    // После записи: строка, прочитанная другим потоком до удаления, уже не попадет в кэш
+    invalidateCachedCar(carId);
+    return ok;
 }
 
 Car DatabaseManager::getCarById(int carId)
 {
-    QSqlQuery query(m_database);
-    query.prepare("SELECT * FROM cars WHERE id=?");
-    query.addBindValue(carId);
-    query.exec();
+    checkEntityRevision();
+    Car car;
+    if (m_carCache.find(carId, &car)) {
+        return car;
+    }
     
-    if (query.next()) {
-        return Car(query.value(0).toInt(),
-                  query.value(1).toString(),
-                  query.value(2).toString(),
-                  static_cast<CarStatus>(query.value(3).toInt()),
-                  query.value(4).toDouble());
+    // Как в getUserById: поколение до чтения, незафиксированные строки не кэшируются
+    const quint64 generation = m_carCache.getGeneration();
+    static const QString sql = selectSql<Car>("WHERE id=?");
+    QSqlQuery& query = cachedQuery(sql);
+    query.addBindValue(carId);
+    car = fetchOne<Car>(query);
+    if (car.getId() > 0 && !inTransaction()) {
+        m_carCache.fill(car.getId(), car, generation);
     }
-    return Car();
+    return car;
 }
 
 QList<Car> DatabaseManager::getAllCars()
 {
-    QList<Car> cars;
-    QSqlQuery query("SELECT * FROM cars", m_database);
-    
-    while (query.next()) {
-        cars.append(Car(query.value(0).toInt(),
-                       query.value(1).toString(),
-                       query.value(2).toString(),
-                       static_cast<CarStatus>(query.value(3).toInt()),
-                       query.value(4).toDouble()));
+    const quint64 generation = m_carCache.getGeneration();
+    static const QString sql = selectSql<Car>();
+    QList<Car> cars = fetchAll<Car>(cachedQuery(sql), tableSizeHint("cars"));
+    // Полный список автомобилей сразу прогревает кэш для последующих чтений по ID
+    if (!inTransaction()) {
+        m_carCache.fillAll(cars, generation);
     }
     return cars;
 }
 
 QList<Car> DatabaseManager::getCarsByBrand(const QString& brand)
 {
-    QList<Car> cars;
-    QSqlQuery query(m_database);
-    query.prepare("SELECT * FROM cars WHERE brand=?");
+    static const QString sql = selectSql<Car>("WHERE brand=?");
+    QSqlQuery& query = cachedQuery(sql);
     query.addBindValue(brand);
-    query.exec();
-    
-    while (query.next()) {
-        cars.append(Car(query.value(0).toInt(),
-                       query.value(1).toString(),
-                       query.value(2).toString(),
-                       static_cast<CarStatus>(query.value(3).toInt()),
-                       query.value(4).toDouble()));
-    }
-    return cars;
+    return fetchAll<Car>(query);
 }
 
 QList<Car> DatabaseManager::getAvailableCars()
 {
-    QList<Car> cars;
-    QSqlQuery query(m_database);
-    query.prepare("SELECT * FROM cars WHERE status=?");
+    static const QString sql = selectSql<Car>("WHERE status=?");
+    QSqlQuery& query = cachedQuery(sql);
     query.addBindValue(static_cast<int>(CarStatus::Available));
-    query.exec();
-    
-    while (query.next()) {
-        cars.append(Car(query.value(0).toInt(),
-                       query.value(1).toString(),
-                       query.value(2).toString(),
-                       static_cast<CarStatus>(query.value(3).toInt()),
-                       query.value(4).toDouble()));
-    }
-    return cars;
+    return fetchAll<Car>(query);
 }
 
 // Rental operations
-bool DatabaseManager::addRental(const Rental& rental)
+bool DatabaseManager::addRental(const Rental& rental, int* newId)
 {
-    QSqlQuery query(m_database);
-    query.prepare("INSERT INTO rentals (car_id, user_id, start_date, end_date, "
-                 "actual_return_date, total_cost, is_completed) "
-                 "VALUES (?, ?, ?, ?, ?, ?, ?)");
+    QSqlQuery& query = cachedQuery("INSERT INTO rentals (car_id, user_id, start_date, end_date, "
+                                   "actual_return_date, total_cost, is_completed) "
+                                   "VALUES (?, ?, ?, ?, ?, ?, ?)");
     query.addBindValue(rental.getCarId());
     query.addBindValue(rental.getUserId());
-    query.addBindValue(rental.getStartDate().toString("yyyy-MM-dd"));
-    query.addBindValue(rental.getEndDate().toString("yyyy-MM-dd"));
-    if (rental.getActualReturnDate().isValid()) {
-        query.addBindValue(rental.getActualReturnDate().toString("yyyy-MM-dd"));
-    } else {
-        query.addBindValue(QVariant());
-    }
+    query.addBindValue(dateToDb(rental.getStartDate()));
+    query.addBindValue(dateToDb(rental.getEndDate()));
+    query.addBindValue(dateToDb(rental.getActualReturnDate()));
     query.addBindValue(rental.getTotalCost());
     query.addBindValue(rental.isCompleted() ? 1 : 0);
-    return query.exec();
+    if (!query.exec()) {
+        return false;
+    }
+    
+    Rental stored = rental;
+    stored.setId(query.lastInsertId().toInt());
+    m_bookingIndex.update(stored);
+    if (newId) {
+        *newId = stored.getId();
+    }
+    return true;
+}
+
+BookingResult DatabaseManager::bookCar(int carId, int userId, const QDate& startDate, const QDate& endDate,
+                                       double totalCost, int* newId)
+{
+    QSqlDatabase database = currentConnection();
+    
+    // IMMEDIATE берет блокировку записи сразу, а не при первой записи: конкурирующее бронирование
+    // ждет (busy_timeout) до фиксации текущего и затем видит созданную им аренду
+    QSqlQuery begin(database);
+    if (!begin.exec("BEGIN IMMEDIATE")) {
+        qDebug() << "Не удалось начать транзакцию бронирования:" << begin.lastError().text();
+        // Занятость - только блокировка, не снятая за busy_timeout; закрытое соединение, ошибка
+        // ввода-вывода или уже открытая транзакция - ошибка бронирования
+        return isBusyError(begin.lastError()) ? BookingResult::Busy : BookingResult::Failed;
+    }
+    enterTransaction();
+    
+    // Состояние читается из БД внутри транзакции, а не из кэша
+    static const QString carSql = selectSql<Car>("WHERE id=?");
+    QSqlQuery& carQuery = cachedQuery(carSql);
+    carQuery.addBindValue(carId);
+    bool carRead = carQuery.exec();
+    Car car;
+    if (carRead && carQuery.next()) {
+        car = RowMapper<Car>::map(carQuery);
+    }
+    carQuery.finish();
+    
+    BookingResult rejection = BookingResult::Booked;
+    if (!carRead) {
+        qDebug() << "Ошибка чтения автомобиля при бронировании:" << carQuery.lastError().text();
+        rejection = BookingResult::Failed;
+    } else if (car.getId() == 0) {
+        rejection = BookingResult::CarNotFound;
+    } else if (car.getStatus() != CarStatus::Available && car.getStatus() != CarStatus::Reserved) {
+        rejection = BookingResult::CarUnavailable;
+    } else {
+        QSqlQuery& overlapQuery = cachedQuery("SELECT 1 FROM rentals WHERE car_id=? AND is_completed=0 "
+                                              "AND start_date <= ? AND end_date >= ? LIMIT 1");
+        overlapQuery.addBindValue(carId);
+        overlapQuery.addBindValue(dateToDb(endDate));
+        overlapQuery.addBindValue(dateToDb(startDate));
+        if (!overlapQuery.exec()) {
+            rejection = BookingResult::Failed;
+        } else if (overlapQuery.next()) {
+            rejection = BookingResult::PeriodTaken;
+        }
+        overlapQuery.finish();
+    }
+    if (rejection != BookingResult::Booked) {
+        // Записей не было - кэш и индекс аренд сбрасывать не нужно
+        database.rollback();
+        leaveTransaction(true);
+        return rejection;
+    }
+    
+    Rental rental(0, carId, userId, startDate, endDate, totalCost, false);
+    if (!addRental(rental, newId) || !updateCarStatus(carId, CarStatus::Rented) || !commitTransaction()) {
+        rollbackTransaction();
+        return BookingResult::Failed;
+    }
+    return BookingResult::Booked;
 }
 
 bool DatabaseManager::updateRental(const Rental& rental)
 {
-    QSqlQuery query(m_database);
-    query.prepare("UPDATE rentals SET car_id=?, user_id=?, start_date=?, end_date=?, "
-                 "actual_return_date=?, total_cost=?, is_completed=? WHERE id=?");
+    QSqlQuery& query = cachedQuery("UPDATE rentals SET car_id=?, user_id=?, start_date=?, end_date=?, "
+                                   "actual_return_date=?, total_cost=?, is_completed=? WHERE id=?");
     query.addBindValue(rental.getCarId());
     query.addBindValue(rental.getUserId());
-    query.addBindValue(rental.getStartDate().toString("yyyy-MM-dd"));
-    query.addBindValue(rental.getEndDate().toString("yyyy-MM-dd"));
-    if (rental.getActualReturnDate().isValid()) {
-        query.addBindValue(rental.getActualReturnDate().toString("yyyy-MM-dd"));
-    } else {
-        query.addBindValue(QVariant());
-    }
+    query.addBindValue(dateToDb(rental.getStartDate()));
+    query.addBindValue(dateToDb(rental.getEndDate()));
+    query.addBindValue(dateToDb(rental.getActualReturnDate()));
     query.addBindValue(rental.getTotalCost());
     query.addBindValue(rental.isCompleted() ? 1 : 0);
     query.addBindValue(rental.getId());
-    return query.exec();
+    if (!query.exec()) {
+        return false;
+    }
+    
+    if (query.numRowsAffected() > 0) {
+        m_bookingIndex.update(rental);
+    }
+    return true;
 }
 
 bool DatabaseManager::deleteRental(int rentalId)
 {
-    QSqlQuery query(m_database);
-    query.prepare("DELETE FROM rentals WHERE id=?");
+    QSqlQuery& query = cachedQuery("DELETE FROM rentals WHERE id=?");
     query.addBindValue(rentalId);
+    if (!query.exec()) {
+        return false;
+    }
+    
+    m_bookingIndex.remove(rentalId);
+    return true;
+}
+
+int DatabaseManager::getMaintenanceValue(const QString& name, int defaultValue)
+{
+    QSqlQuery& query = cachedQuery("SELECT int_value FROM maintenance_state WHERE name=?");
+    query.addBindValue(name);
+    int value = defaultValue;
+    if (query.exec() && query.next()) {
+        value = query.value(0).toInt();
+    }
+    query.finish();
+    return value;
+}
+
+bool DatabaseManager::setMaintenanceValue(const QString& name, int value)
+{
+    QSqlQuery& query = cachedQuery("INSERT OR REPLACE INTO maintenance_state (name, int_value) VALUES (?, ?)");
+    query.addBindValue(name);
+    query.addBindValue(value);
     return query.exec();
 }
 
+bool DatabaseManager::analyzeDatabase()
+{
+    QSqlQuery query(currentConnection());
+    if (!query.exec("ANALYZE")) {
+        qDebug() << "Ошибка ANALYZE:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseManager::vacuumDatabase()
+{
+    // VACUUM не выполняется, пока на соединении есть незавершенные запросы
+    for (QSqlQuery* cached : currentStatementCache()) {
+        cached->finish();
+    }
+    QSqlQuery query(currentConnection());
+    if (!query.exec("VACUUM")) {
+        qDebug() << "Ошибка VACUUM:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool DatabaseManager::loadBookingIndex()
+{
+    static const QString sql = selectSql<Rental>("WHERE is_completed=0");
+    QSqlQuery& query = cachedQuery(sql);
+    if (!query.exec()) {
+        qDebug() << "Ошибка чтения активных аренд:" << query.lastError().text();
+        m_bookingIndex.clear();
+        return false;
+    }
+    
+    QList<Rental> activeRentals;
+    visitRows<Rental>(query, [&activeRentals](const Rental& rental) {
+        activeRentals.append(rental);
+        return true;
+    });
+    query.finish();
+    m_bookingIndex.load(activeRentals);
+    return true;
+}
+
 Rental DatabaseManager::getRentalById(int rentalId)
 {
-    QSqlQuery query(m_database);
-    query.prepare("SELECT * FROM rentals WHERE id=?");
+    static const QString sql = selectSql<Rental>("WHERE id=?");
+    QSqlQuery& query = cachedQuery(sql);
     query.addBindValue(rentalId);
-    query.exec();
-    
-    if (query.next()) {
-        Rental rental(query.value(0).toInt(),
-                     query.value(1).toInt(),
-                     query.value(2).toInt(),
-                     QDate::fromString(query.value(3).toString(), "yyyy-MM-dd"),
-                     QDate::fromString(query.value(4).toString(), "yyyy-MM-dd"),
-                     query.value(6).toDouble(),
-                     query.value(7).toInt() == 1);
-        if (!query.value(5).isNull()) {
-            rental.setActualReturnDate(QDate::fromString(query.value(5).toString(), "yyyy-MM-dd"));
-        }
-        return rental;
-    }
-    return Rental();
+    return fetchOne<Rental>(query);
 }
 
 QList<Rental> DatabaseManager::getAllRentals()
 {
-    QList<Rental> rentals;
-    QSqlQuery query("SELECT * FROM rentals", m_database);
-    
-    while (query.next()) {
-        Rental rental(query.value(0).toInt(),
-                     query.value(1).toInt(),
-                     query.value(2).toInt(),
-                     QDate::fromString(query.value(3).toString(), "yyyy-MM-dd"),
-                     QDate::fromString(query.value(4).toString(), "yyyy-MM-dd"),
-                     query.value(6).toDouble(),
-                     query.value(7).toInt() == 1);
-        if (!query.value(5).isNull()) {
-            rental.setActualReturnDate(QDate::fromString(query.value(5).toString(), "yyyy-MM-dd"));
-        }
-        rentals.append(rental);
-    }
-    return rentals;
+    static const QString sql = selectSql<Rental>();
+    return fetchAll<Rental>(cachedQuery(sql), tableSizeHint("rentals"));
 }
 
 QList<Rental> DatabaseManager::getRentalsByUserId(int userId)
 {
-    QList<Rental> rentals;
-    QSqlQuery query(m_database);
-    query.prepare("SELECT * FROM rentals WHERE user_id=?");
+    static const QString sql = selectSql<Rental>("WHERE user_id=?");
+    QSqlQuery& query = cachedQuery(sql);
     query.addBindValue(userId);
-    query.exec();
-    
-    while (query.next()) {
-        Rental rental(query.value(0).toInt(),
-                     query.value(1).toInt(),
-                     query.value(2).toInt(),
-                     QDate::fromString(query.value(3).toString(), "yyyy-MM-dd"),
-                     QDate::fromString(query.value(4).toString(), "yyyy-MM-dd"),
-                     query.value(6).toDouble(),
-                     query.value(7).toInt() == 1);
-        if (!query.value(5).isNull()) {
-            rental.setActualReturnDate(QDate::fromString(query.value(5).toString(), "yyyy-MM-dd"));
-        }
-        rentals.append(rental);
-    }
-    return rentals;
+    return fetchAll<Rental>(query);
 }
 
 QList<Rental> DatabaseManager::getRentalsByDateRange(const QDate& startDate, const QDate& endDate)
 {
-    QList<Rental> rentals;
-    QSqlQuery query(m_database);
-    query.prepare("SELECT * FROM rentals WHERE start_date >= ? AND end_date <= ?");
-    query.addBindValue(startDate.toString("yyyy-MM-dd"));
-    query.addBindValue(endDate.toString("yyyy-MM-dd"));
-    query.exec();
-    
-    while (query.next()) {
-        Rental rental(query.value(0).toInt(),
-                     query.value(1).toInt(),
-                     query.value(2).toInt(),
-                     QDate::fromString(query.value(3).toString(), "yyyy-MM-dd"),
-                     QDate::fromString(query.value(4).toString(), "yyyy-MM-dd"),
-                     query.value(6).toDouble(),
-                     query.value(7).toInt() == 1);
-        if (!query.value(5).isNull()) {
-            rental.setActualReturnDate(QDate::fromString(query.value(5).toString(), "yyyy-MM-dd"));
-        }
-        rentals.append(rental);
-    }
-    return rentals;
+    static const QString sql = selectSql<Rental>("WHERE start_date >= ? AND end_date <= ?");
+    QSqlQuery& query = cachedQuery(sql);
+    query.addBindValue(dateToDb(startDate));
+    query.addBindValue(dateToDb(endDate));
+    return fetchAll<Rental>(query);
+}
+
+QList<RentalView> DatabaseManager::getRentalViewsByUserId(int userId)
+{
+    static const QString sql = QString("SELECT %1 FROM rentals r "
+                                       "LEFT JOIN users u ON r.user_id = u.id "
+                                       "LEFT JOIN cars c ON r.car_id = c.id "
+                                       "WHERE r.user_id = ?").arg(RowMapper<RentalView>::qualifiedColumns());
+    QSqlQuery& query = cachedQuery(sql);
+    query.addBindValue(userId);
+    return fetchAll<RentalView>(query);
 }
 
 QList<Rental> DatabaseManager::getActiveRentals()
 {
-    QList<Rental> rentals;
-    QSqlQuery query(m_database);
-    query.prepare("SELECT * FROM rentals WHERE is_completed=0");
-    query.exec();
-    
-    while (query.next()) {
-        Rental rental(query.value(0).toInt(),
-                     query.value(1).toInt(),
-                     query.value(2).toInt(),
-                     QDate::fromString(query.value(3).toString(), "yyyy-MM-dd"),
-                     QDate::fromString(query.value(4).toString(), "yyyy-MM-dd"),
-                     query.value(6).toDouble(),
-                     query.value(7).toInt() == 1);
-        if (!query.value(5).isNull()) {
-            rental.setActualReturnDate(QDate::fromString(query.value(5).toString(), "yyyy-MM-dd"));
-        }
-        rentals.append(rental);
-    }
-    return rentals;
+    static const QString sql = selectSql<Rental>("WHERE is_completed=0");
+    return fetchAll<Rental>(cachedQuery(sql));
 }
 
 // Fine operations
 bool DatabaseManager::addFine(const Fine& fine)
 {
-    QSqlQuery query(m_database);
-    query.prepare("INSERT INTO fines (rental_id, amount, date, reason) "
-                 "VALUES (?, ?, ?, ?)");
+    QSqlQuery& query = cachedQuery("INSERT INTO fines (rental_id, amount, date, reason) "
+                                   "VALUES (?, ?, ?, ?)");
     query.addBindValue(fine.getRentalId());
     query.addBindValue(fine.getAmount());
-    query.addBindValue(fine.getDate().toString("yyyy-MM-dd"));
+    query.addBindValue(dateToDb(fine.getDate()));
     query.addBindValue(fine.getReason());
     return query.exec();
 }
 
 bool DatabaseManager::updateFine(const Fine& fine)
 {
-    QSqlQuery query(m_database);
-    query.prepare("UPDATE fines SET rental_id=?, amount=?, date=?, reason=? WHERE id=?");
+    QSqlQuery& query = cachedQuery("UPDATE fines SET rental_id=?, amount=?, date=?, reason=? WHERE id=?");
     query.addBindValue(fine.getRentalId());
     query.addBindValue(fine.getAmount());
-    query.addBindValue(fine.getDate().toString("yyyy-MM-dd"));
+    query.addBindValue(dateToDb(fine.getDate()));
     query.addBindValue(fine.getReason());
     query.addBindValue(fine.getId());
     return query.exec();
@@ -525,195 +1242,357 @@ bool DatabaseManager::updateFine(const Fine& fine)
 
 bool DatabaseManager::deleteFine(int fineId)
 {
-    QSqlQuery query(m_database);
-    query.prepare("DELETE FROM fines WHERE id=?");
+    QSqlQuery& query = cachedQuery("DELETE FROM fines WHERE id=?");
     query.addBindValue(fineId);
     return query.exec();
 }
 
 Fine DatabaseManager::getFineById(int fineId)
 {
-    QSqlQuery query(m_database);
-    query.prepare("SELECT * FROM fines WHERE id=?");
+    static const QString sql = selectSql<Fine>("WHERE id=?");
+    QSqlQuery& query = cachedQuery(sql);
     query.addBindValue(fineId);
-    query.exec();
-    
-    if (query.next()) {
-        return Fine(query.value(0).toInt(),
-                   query.value(1).toInt(),
-                   query.value(2).toDouble(),
-                   QDate::fromString(query.value(3).toString(), "yyyy-MM-dd"),
-                   query.value(4).toString());
-    }
-    return Fine();
+    return fetchOne<Fine>(query);
 }
 
 QList<Fine> DatabaseManager::getAllFines()
 {
-    QList<Fine> fines;
-    QSqlQuery query("SELECT * FROM fines", m_database);
-    
-    while (query.next()) {
-        fines.append(Fine(query.value(0).toInt(),
-                         query.value(1).toInt(),
-                         query.value(2).toDouble(),
-                         QDate::fromString(query.value(3).toString(), "yyyy-MM-dd"),
-                         query.value(4).toString()));
-    }
-    return fines;
+    static const QString sql = selectSql<Fine>();
+    return fetchAll<Fine>(cachedQuery(sql), tableSizeHint("fines"));
 }
 
-QList<Fine> DatabaseManager::getFinesByRentalId(int rentalId)
+QHash<int, Fine> DatabaseManager::getOverdueFinesOfActiveRentals()
 {
-    QList<Fine> fines;
-    QSqlQuery query(m_database);
-    query.prepare("SELECT * FROM fines WHERE rental_id=?");
-    query.addBindValue(rentalId);
-    query.exec();
-    
-    while (query.next()) {
-        fines.append(Fine(query.value(0).toInt(),
-                         query.value(1).toInt(),
-                         query.value(2).toDouble(),
-                         QDate::fromString(query.value(3).toString(), "yyyy-MM-dd"),
-                         query.value(4).toString()));
+    // Для каждой активной аренды - первый штраф, начисленный не раньше даты окончания
+    static const QString sql = QString("SELECT %1 FROM fines f JOIN rentals r ON f.rental_id = r.id "
+                                       "WHERE r.is_completed = 0 AND f.date >= r.end_date "
+                                       "ORDER BY f.id").arg(RowMapper<Fine>::qualifiedColumns());
+    QHash<int, Fine> fines;
+    QSqlQuery& query = cachedQuery(sql);
+    if (!query.exec()) {
+        qDebug() << "Ошибка чтения штрафов:" << query.lastError().text();
+        return fines;
     }
+    visitRows<Fine>(query, [&fines](const Fine& fine) {
+        if (!fines.contains(fine.getRentalId())) {
+            fines.insert(fine.getRentalId(), fine);
+        }
+        return true;
+    });
+    query.finish();
     return fines;
 }
 
-// Расширенный поиск
-QList<Car> DatabaseManager::searchCars(const QString& brand, const QString& model, CarStatus status)
+int DatabaseManager::applyOverdueFines(const QDate& today, double multiplier)
 {
-    QList<Car> cars;
-    QSqlQuery query(m_database);
+    // Сначала обновление: добавленные следом штрафы уже имеют актуальную сумму
+    static const QString updateSql = overdueFineUpdateSql();
+    static const QString insertSql = overdueFineInsertSql();
+    
+    QSqlQuery& update = cachedQuery(updateSql);
+    for (const QVariant& value : overdueFineUpdateValues(today, multiplier)) {
+        update.addBindValue(value);
+    }
+    if (!update.exec()) {
+        qDebug() << "Ошибка обновления штрафов за просрочку:" << update.lastError().text();
+        return -1;
+    }
+    int affected = update.numRowsAffected();
     
-    QString sql = "SELECT * FROM cars WHERE 1=1";
-    if (!brand.isEmpty()) {
-        sql += " AND brand LIKE '%" + brand + "%'";
+    QSqlQuery& insert = cachedQuery(insertSql);
+    for (const QVariant& value : overdueFineInsertValues(today, multiplier)) {
+        insert.addBindValue(value);
     }
-    if (!model.isEmpty()) {
-        sql += " AND model LIKE '%" + model + "%'";
+    if (!insert.exec()) {
+        qDebug() << "Ошибка начисления штрафов за просрочку:" << insert.lastError().text();
+        return -1;
     }
+    return affected + insert.numRowsAffected();
+}
+
+QList<Fine> DatabaseManager::getFinesByRentalId(int rentalId)
+{
+    static const QString sql = selectSql<Fine>("WHERE rental_id=?");
+    QSqlQuery& query = cachedQuery(sql);
+    query.addBindValue(rentalId);
+    return fetchAll<Fine>(query);
+}
+
+// Расширенный поиск
+QList<Car> DatabaseManager::searchCars(const QString& brand, const QString& model, CarStatus status, CarSearchMode mode)
+{
+    QStringList conditions;
+    QVariantList values;
+    appendTextFilter("brand", brand, mode, conditions, values);
+    appendTextFilter("model", model, mode, conditions, values);
+    // Без фильтров по тексту статус "Доступен" означает "любой статус" (прежнее поведение)
     if (status != CarStatus::Available || !brand.isEmpty() || !model.isEmpty()) {
-        sql += " AND status = " + QString::number(static_cast<int>(status));
+        conditions << "status = ?";
+        values << static_cast<int>(status);
     }
     
-    query.exec(sql);
-    
-    while (query.next()) {
-        cars.append(Car(query.value(0).toInt(),
-                       query.value(1).toString(),
-                       query.value(2).toString(),
-                       static_cast<CarStatus>(query.value(3).toInt()),
-                       query.value(4).toDouble()));
+    // Текст запроса зависит только от набора фильтров, а не от введенных значений,
+    // поэтому все варианты поиска попадают в кэш подготовленных запросов
+    QSqlQuery& query = cachedQuery(selectSql<Car>(conditions.isEmpty() ? QString() : "WHERE " + conditions.join(" AND ")));
+    for (const QVariant& value : values) {
+        query.addBindValue(value);
     }
-    return cars;
+    return fetchAll<Car>(query);
 }
 
-QList<Rental> DatabaseManager::searchRentalsByClientName(const QString& clientName)
+QList<Car> DatabaseManager::findAvailableCars(const QDate& startDate, const QDate& endDate,
+                                             const QString& brand, double maxPrice)
 {
-    QList<Rental> rentals;
-    QSqlQuery query(m_database);
-    
-    query.prepare("SELECT r.* FROM rentals r "
-                 "JOIN users u ON r.user_id = u.id "
-                 "WHERE u.username LIKE ?");
-    query.addBindValue("%" + clientName + "%");
-    query.exec();
+    // Статус, отсутствие пересекающейся активной аренды (индекс idx_rentals_car_dates),
+    // марка и цена проверяются одним запросом - таблица cars не читается целиком в память.
+    // Допустимые статусы - те же, что в RentalService::isCarAvailable и bookCar
+    QStringList conditions;
+    QVariantList values;
+    conditions << "status IN (?, ?)"
+               << "NOT EXISTS (SELECT 1 FROM rentals r WHERE r.car_id = cars.id AND r.is_completed = 0 "
+                  "AND r.start_date <= ? AND r.end_date >= ?)";
+    values << static_cast<int>(CarStatus::Available) << static_cast<int>(CarStatus::Reserved)
+           << dateToDb(endDate) << dateToDb(startDate);
+    appendTextFilter("brand", brand, CarSearchMode::Prefix, conditions, values);
+    if (maxPrice > 0.0) {
+        conditions << "daily_price <= ?";
+        values << maxPrice;
+    }
     
-    while (query.next()) {
-        Rental rental(query.value(0).toInt(),
-                     query.value(1).toInt(),
-                     query.value(2).toInt(),
-                     QDate::fromString(query.value(3).toString(), "yyyy-MM-dd"),
-                     QDate::fromString(query.value(4).toString(), "yyyy-MM-dd"),
-                     query.value(6).toDouble(),
-                     query.value(7).toInt() == 1);
-        if (!query.value(5).isNull()) {
-            rental.setActualReturnDate(QDate::fromString(query.value(5).toString(), "yyyy-MM-dd"));
-        }
-        rentals.append(rental);
+    QSqlQuery& query = cachedQuery(selectSql<Car>("WHERE " + conditions.join(" AND ")));
+    for (const QVariant& value : values) {
+        query.addBindValue(value);
     }
-    return rentals;
+    return fetchAll<Car>(query);
 }
 
-QList<Rental> DatabaseManager::searchRentalsByDate(const QDate& date)
+void DatabaseManager::appendTextFilter(const QString& column, const QString& text, CarSearchMode mode,
+                                       QStringList& conditions, QVariantList& values)
 {
-    QList<Rental> rentals;
-    QSqlQuery query(m_database);
+    if (text.isEmpty()) {
+        return;
+    }
     
-    query.prepare("SELECT * FROM rentals WHERE start_date <= ? AND end_date >= ?");
-    query.addBindValue(date.toString("yyyy-MM-dd"));
-    query.addBindValue(date.toString("yyyy-MM-dd"));
-    query.exec();
+    QString lowerBound;
+    QString upperBound;
+    if (mode == CarSearchMode::Prefix && prefixRange(text, &lowerBound, &upperBound)) {
+        // Диапазон по индексу с COLLATE NOCASE: строки, начинающиеся с префикса без учета регистра
+        conditions << QString("%1 >= ? COLLATE NOCASE AND %1 < ? COLLATE NOCASE").arg(column);
+        values << lowerBound << upperBound;
+        return;
+    }
     
-    while (query.next()) {
-        Rental rental(query.value(0).toInt(),
-                     query.value(1).toInt(),
-                     query.value(2).toInt(),
-                     QDate::fromString(query.value(3).toString(), "yyyy-MM-dd"),
-                     QDate::fromString(query.value(4).toString(), "yyyy-MM-dd"),
-                     query.value(6).toDouble(),
-                     query.value(7).toInt() == 1);
-        if (!query.value(5).isNull()) {
-            rental.setActualReturnDate(QDate::fromString(query.value(5).toString(), "yyyy-MM-dd"));
+    // Подстрока требует полного просмотра таблицы
+    conditions << QString("%1 LIKE ? ESCAPE '\\'").arg(column);
+    values << QString(mode == CarSearchMode::Prefix ? "%1%" : "%%1%").arg(escapeLike(text));
+}
+
+bool DatabaseManager::isBusyError(const QSqlError& error)
+{
+    // Основной код SQLite - младший байт расширенного (SQLITE_BUSY_SNAPSHOT = 517 и т.п.)
+    bool ok = false;
+    int code = error.nativeErrorCode().toInt(&ok) & 0xff;
+    return ok && (code == SQLITE_BUSY_CODE || code == SQLITE_LOCKED_CODE);
+}
+
+QString DatabaseManager::escapeLike(const QString& text)
+{
+    QString escaped = text;
+    escaped.replace("\\", "\\\\");
+    escaped.replace("%", "\\%");
+    escaped.replace("_", "\\_");
+    return escaped;
+}
+
+bool DatabaseManager::prefixRange(const QString& prefix, QString* lowerBound, QString* upperBound)
+{
+    // NOCASE в SQLite сравнивает строки побайтно, приводя к нижнему регистру только ASCII,
+    // поэтому границы строятся так же: ASCII в нижний регистр, остальные символы как есть
+    QString folded = prefix;
+    for (int i = 0; i < folded.size(); ++i) {
+        ushort code = folded.at(i).unicode();
+        if (code >= 'A' && code <= 'Z') {
+            folded[i] = QChar(code + ('a' - 'A'));
         }
-        rentals.append(rental);
     }
-    return rentals;
+    
+    // Верхняя граница - префикс с увеличенным последним символом.
+    // Для суррогатных пар и U+FFFF такой границы нет - тогда используется LIKE
+    ushort last = folded.at(folded.size() - 1).unicode();
+    if (last >= 0xD800 && last <= 0xDFFF) {
+        return false;
+    }
+    if (last == 0xFFFF) {
+        return false;
+    }
+    // Увеличенный символ не должен попадать в A-Z (последний символ '@'): NOCASE сравнит его
+    // как строчный, и диапазон [x@, xa) захватит x[, x\, x], x^, x_ и x`
+    ushort next = static_cast<ushort>(last + 1);
+    if (next >= 'A' && next <= 'Z') {
+        return false;
+    }
+    
+    *lowerBound = folded;
+    *upperBound = folded;
+    (*upperBound)[folded.size() - 1] = QChar(next);
+    return true;
+}
+
+QList<Rental> DatabaseManager::searchRentalsByClientName(const QString& clientName)
+{
+    return searchRentalsByText(clientName, QString());
+}
+
+QList<Rental> DatabaseManager::searchRentalsByDate(const QDate& date)
+{
+    static const QString sql = selectSql<Rental>("WHERE start_date <= ? AND end_date >= ?");
+    QSqlQuery& query = cachedQuery(sql);
+    query.addBindValue(dateToDb(date));
+    query.addBindValue(dateToDb(date));
+    return fetchAll<Rental>(query);
 }
 
 QList<Rental> DatabaseManager::searchRentalsByDateRange(const QDate& startDate, const QDate& endDate)
 {
-    QList<Rental> rentals;
-    QSqlQuery query(m_database);
-    
     // Ищем аренды, которые пересекаются с указанным диапазоном
     // Аренда пересекается, если: start_date <= endDate AND end_date >= startDate
-    query.prepare("SELECT * FROM rentals WHERE start_date <= ? AND end_date >= ?");
-    query.addBindValue(endDate.toString("yyyy-MM-dd"));
-    query.addBindValue(startDate.toString("yyyy-MM-dd"));
-    query.exec();
+    static const QString sql = selectSql<Rental>("WHERE start_date <= ? AND end_date >= ?");
+    QSqlQuery& query = cachedQuery(sql);
+    query.addBindValue(dateToDb(endDate));
+    query.addBindValue(dateToDb(startDate));
+    return fetchAll<Rental>(query);
+}
+
+QList<Rental> DatabaseManager::searchRentalsByCarBrand(const QString& brand)
+{
+    return searchRentalsByText(QString(), brand);
+}
+
+QList<Rental> DatabaseManager::searchRentalsByText(const QString& clientText, const QString& carText)
+{
+    RentalSearchCriteria criteria;
+    criteria.clientText = clientText;
+    criteria.carText = carText;
+    return searchRentals(criteria);
+}
+
+QList<Rental> DatabaseManager::searchRentals(const RentalSearchCriteria& criteria)
+{
+    RentalQueryBuilder builder(m_hasRentalSearchIndex);
+    builder.where(criteria);
     
-    while (query.next()) {
-        Rental rental(query.value(0).toInt(),
-                     query.value(1).toInt(),
-                     query.value(2).toInt(),
-                     QDate::fromString(query.value(3).toString(), "yyyy-MM-dd"),
-                     QDate::fromString(query.value(4).toString(), "yyyy-MM-dd"),
-                     query.value(6).toDouble(),
-                     query.value(7).toInt() == 1);
-        if (!query.value(5).isNull()) {
-            rental.setActualReturnDate(QDate::fromString(query.value(5).toString(), "yyyy-MM-dd"));
+    QSqlQuery& query = cachedQuery(builder.selectSql(RowMapper<Rental>::qualifiedColumns()));
+    for (const QVariant& value : builder.getBindValues()) {
+        query.addBindValue(value);
+    }
+    return fetchAll<Rental>(query, criteria.isEmpty() ? tableSizeHint("rentals") : 0);
+}
+
+RentalPage DatabaseManager::searchRentalsPage(const RentalSearchCriteria& criteria,
+                                              const RentalPageCursor& cursor, int pageSize)
+{
+    RentalPage page;
+    if (pageSize <= 0) {
+        return page;
+    }
+    
+    // Запрашиваем на одну строку больше: ее наличие означает, что есть следующая страница
+    RentalQueryBuilder builder(m_hasRentalSearchIndex);
+    builder.where(criteria).withDetails().after(cursor).limit(pageSize + 1);
+    
+    QSqlQuery& query = cachedQuery(builder.selectSql(RowMapper<RentalView>::qualifiedColumns()));
+    for (const QVariant& value : builder.getBindValues()) {
+        query.addBindValue(value);
+    }
+    page.rentals = fetchAll<RentalView>(query, pageSize + 1);
+    
+    page.hasMore = page.rentals.size() > pageSize;
+    if (page.hasMore) {
+        page.rentals.removeLast();
+    }
+    if (!page.rentals.isEmpty()) {
+        const Rental& last = page.rentals.last().getRental();
+        page.next = RentalPageCursor(last.getStartDate(), last.getId());
+    }
+    
+    // Оценка общего числа считается только для первой страницы
+    if (!cursor.isValid()) {
+        if (!page.hasMore) {
+            page.totalEstimate = page.rentals.size();
+        } else if (criteria.isEmpty()) {
+            page.totalEstimate = tableSizeHint("rentals");
+        } else {
+            RentalQueryBuilder countBuilder(m_hasRentalSearchIndex);
+            countBuilder.where(criteria);
+            QSqlQuery& countQuery = cachedQuery(countBuilder.selectSql("COUNT(*)"));
+            for (const QVariant& value : countBuilder.getBindValues()) {
+                countQuery.addBindValue(value);
+            }
+            if (countQuery.exec() && countQuery.next()) {
+                page.totalEstimate = countQuery.value(0).toInt();
+            }
+            countQuery.finish();
         }
-        rentals.append(rental);
     }
-    return rentals;
+    return page;
 }
 
-QList<Rental> DatabaseManager::searchRentalsByCarBrand(const QString& brand)
+bool DatabaseManager::ensureRentalSearchIndex()
 {
-    QList<Rental> rentals;
     QSqlQuery query(m_database);
+    if (query.exec("SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'rental_search_fts'") && query.next()) {
+        m_hasRentalSearchIndex = true;
+        return true;
+    }
+    query.finish();
     
-    query.prepare("SELECT r.* FROM rentals r "
-                 "JOIN cars c ON r.car_id = c.id "
-                 "WHERE c.brand LIKE ?");
-    query.addBindValue("%" + brand + "%");
-    query.exec();
+    // Индекс создается при первом запуске со сборкой SQLite, в которой есть FTS5.
+    // Если модуля нет, поиск работает через LIKE
+    if (!m_database.transaction()) {
+        return false;
+    }
+    if (!query.exec("CREATE VIRTUAL TABLE rental_search_fts USING fts5("
+                    "username, full_name, brand, model, tokenize = 'unicode61', prefix = '2 3')")) {
+        qDebug() << "FTS5 недоступен, поиск аренд по тексту без индекса:" << query.lastError().text();
+        m_database.rollback();
+        m_hasRentalSearchIndex = false;
+        return true;
+    }
     
-    while (query.next()) {
-        Rental rental(query.value(0).toInt(),
-                     query.value(1).toInt(),
-                     query.value(2).toInt(),
-                     QDate::fromString(query.value(3).toString(), "yyyy-MM-dd"),
-                     QDate::fromString(query.value(4).toString(), "yyyy-MM-dd"),
-                     query.value(6).toDouble(),
-                     query.value(7).toInt() == 1);
-        if (!query.value(5).isNull()) {
-            rental.setActualReturnDate(QDate::fromString(query.value(5).toString(), "yyyy-MM-dd"));
-        }
-        rentals.append(rental);
+    // rowid записи индекса = id аренды; триггеры поддерживают копии текста в актуальном состоянии
+    bool ok = execStatements(QStringList()
+        << "INSERT INTO rental_search_fts (rowid, username, full_name, brand, model) "
+           "SELECT r.id, u.username, u.full_name, c.brand, c.model FROM rentals r "
+           "LEFT JOIN users u ON r.user_id = u.id LEFT JOIN cars c ON r.car_id = c.id"
+        << "CREATE TRIGGER IF NOT EXISTS trg_rentals_fts_insert AFTER INSERT ON rentals BEGIN "
+           "INSERT INTO rental_search_fts (rowid, username, full_name, brand, model) VALUES (NEW.id, "
+           "(SELECT username FROM users WHERE id = NEW.user_id), (SELECT full_name FROM users WHERE id = NEW.user_id), "
+           "(SELECT brand FROM cars WHERE id = NEW.car_id), (SELECT model FROM cars WHERE id = NEW.car_id)); END"
+        << "CREATE TRIGGER IF NOT EXISTS trg_rentals_fts_update AFTER UPDATE OF car_id, user_id ON rentals BEGIN "
+           "DELETE FROM rental_search_fts WHERE rowid = OLD.id; "
+           "INSERT INTO rental_search_fts (rowid, username, full_name, brand, model) VALUES (NEW.id, "
+           "(SELECT username FROM users WHERE id = NEW.user_id), (SELECT full_name FROM users WHERE id = NEW.user_id), "
+           "(SELECT brand FROM cars WHERE id = NEW.car_id), (SELECT model FROM cars WHERE id = NEW.car_id)); END"
+        << "CREATE TRIGGER IF NOT EXISTS trg_rentals_fts_delete AFTER DELETE ON rentals BEGIN "
+           "DELETE FROM rental_search_fts WHERE rowid = OLD.id; END"
+        << "CREATE TRIGGER IF NOT EXISTS trg_users_fts_update AFTER UPDATE OF username, full_name ON users BEGIN "
+           "UPDATE rental_search_fts SET username = NEW.username, full_name = NEW.full_name "
+           "WHERE rowid IN (SELECT id FROM rentals WHERE user_id = NEW.id); END"
+        << "CREATE TRIGGER IF NOT EXISTS trg_users_fts_delete AFTER DELETE ON users BEGIN "
+           "UPDATE rental_search_fts SET username = NULL, full_name = NULL "
+           "WHERE rowid IN (SELECT id FROM rentals WHERE user_id = OLD.id); END"
+        << "CREATE TRIGGER IF NOT EXISTS trg_cars_fts_update AFTER UPDATE OF brand, model ON cars BEGIN "
+           "UPDATE rental_search_fts SET brand = NEW.brand, model = NEW.model "
+           "WHERE rowid IN (SELECT id FROM rentals WHERE car_id = NEW.id); END"
+        << "CREATE TRIGGER IF NOT EXISTS trg_cars_fts_delete AFTER DELETE ON cars BEGIN "
+           "UPDATE rental_search_fts SET brand = NULL, model = NULL "
+           "WHERE rowid IN (SELECT id FROM rentals WHERE car_id = OLD.id); END");
+    
+    if (!ok || !m_database.commit()) {
+        m_database.rollback();
+        return false;
     }
-    return rentals;
+    
+    m_hasRentalSearchIndex = true;
+    return true;
 }
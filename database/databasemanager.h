@@ -2,12 +2,48 @@
 #define DATABASEMANAGER_H
 
 #include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
 #include <QString>
+#include <QStringList>
 #include <QList>
+#include <QHash>
+#include <QMap>
+#include <QThread>
+#include <QAtomicInt>
+#include <QThreadStorage>
+#include <QSet>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <functional>
 #include "../models/user.h"
 #include "../models/car.h"
 #include "../models/rental.h"
 #include "../models/fine.h"
+#include "../models/rentalview.h"
+#include "rowmapper.h"
+#include "databaseconfig.h"
+#include "connectionpool.h"
+#include "useridallocator.h"
+#include "rentalquerybuilder.h"
+#include "entitycache.h"
+#include "bookingindex.h"
+
+// Режим текстового поиска автомобилей
+enum class CarSearchMode {
+    Prefix,     // Начало строки без учета регистра (использует индекс)
+    Substring   // Вхождение в любом месте (полный просмотр таблицы)
+};
+
+// Результат бронирования автомобиля (DatabaseManager::bookCar)
+enum class BookingResult {
+    Booked,             // Аренда создана, автомобиль переведен в статус "В аренде"
+    CarNotFound,        // Автомобиль не найден
+    CarUnavailable,     // Статус автомобиля не допускает бронирование
+    PeriodTaken,        // Период пересекается с активной арендой
+    Busy,               // Не удалось получить блокировку записи (истек busy_timeout)
+    Failed              // Ошибка записи
+};
 
 class DatabaseManager
 {
@@ -18,6 +54,24 @@ public:
     void closeDatabase();
     bool isOpen() const;
     
+    // Профиль PRAGMA, применяемый к соединению при открытии
+    const DatabaseConfig& getConfig() const { return m_config; }
+    
+    // Файл настроек database.ini рядом с БД (может отсутствовать)
+    QString getSettingsPath() const { return m_settingsPath; }
+    
+    // Пул соединений для фоновых потоков. Методы DatabaseManager можно вызывать из любого
+    // потока: GUI-поток работает через основное соединение, остальные - через соединение пула
+    ConnectionPool& getConnectionPool() { return m_pool; }
+    
+    // Текущая версия схемы БД (PRAGMA user_version)
+    int getSchemaVersion();
+    
+    // Явные транзакции для пакетных операций (импорт и т.п.)
+    bool beginTransaction();
+    bool commitTransaction();
+    bool rollbackTransaction();
+    
     // User operations
     bool addUser(const User& user);
     bool updateUser(const User& user);
@@ -31,13 +85,24 @@ public:
     bool addCar(const Car& car);
     bool updateCar(const Car& car);
     bool deleteCar(int carId);
+    // Смена только статуса (без перезаписи марки, модели и цены)
+    bool updateCarStatus(int carId, CarStatus status);
+    // Пакетная смена статусов одной транзакцией: по запросу UPDATE ... WHERE id IN (...)
+    // на каждый статус, списки ID делятся на части по CAR_STATUS_CHUNK_SIZE
+    bool updateCarStatuses(const QMap<int, CarStatus>& statuses);
     Car getCarById(int carId);
     QList<Car> getAllCars();
     QList<Car> getCarsByBrand(const QString& brand);
     QList<Car> getAvailableCars();
     
     // Rental operations
-    bool addRental(const Rental& rental);
+    // newId - ID созданной аренды (если указатель передан)
+    bool addRental(const Rental& rental, int* newId = nullptr);
+    // Атомарное бронирование: проверка статуса и пересечений, создание аренды и смена статуса
+    // автомобиля в одной транзакции BEGIN IMMEDIATE. Параллельные бронирования (в том числе из
+    // других потоков и процессов) упорядочиваются блокировкой записи SQLite, поэтому двойная бронь невозможна
+    BookingResult bookCar(int carId, int userId, const QDate& startDate, const QDate& endDate,
+                          double totalCost, int* newId = nullptr);
     bool updateRental(const Rental& rental);
     bool deleteRental(int rentalId);
     Rental getRentalById(int rentalId);
@@ -45,6 +110,8 @@ public:
     QList<Rental> getRentalsByUserId(int userId);
     QList<Rental> getRentalsByDateRange(const QDate& startDate, const QDate& endDate);
     QList<Rental> getActiveRentals();
+    // Аренды пользователя с автомобилем и суммой штрафов - один запрос на всю таблицу
+    QList<RentalView> getRentalViewsByUserId(int userId);
     
     // Fine operations
     bool addFine(const Fine& fine);
@@ -53,13 +120,71 @@ public:
     Fine getFineById(int fineId);
     QList<Fine> getAllFines();
     QList<Fine> getFinesByRentalId(int rentalId);
+    // Штраф за просрочку каждой активной аренды (первый с датой не раньше окончания), ключ - ID аренды
+    QHash<int, Fine> getOverdueFinesOfActiveRentals();
+    // Пересчитать штрафы за просрочку всех активных аренд на дату today двумя запросами
+    // (UPDATE и INSERT ... SELECT). Транзакцию открывает вызывающий.
+    // Возвращает число добавленных и обновленных штрафов или -1 при ошибке
+    int applyOverdueFines(const QDate& today, double multiplier);
+    
+    // Служебные значения фоновых задач (таблица maintenance_state)
+    int getMaintenanceValue(const QString& name, int defaultValue = 0);
+    bool setMaintenanceValue(const QString& name, int value);
+    
+    // Обслуживание файла БД: обновление статистики планировщика запросов и сжатие
+    bool analyzeDatabase();
+    bool vacuumDatabase();
     
     // Расширенный поиск
-    QList<Car> searchCars(const QString& brand, const QString& model, CarStatus status = CarStatus::Available);
+    QList<Car> searchCars(const QString& brand, const QString& model, CarStatus status = CarStatus::Available,
+                          CarSearchMode mode = CarSearchMode::Prefix);
+    // Автомобили, свободные весь период (см. CarService::findAvailableCars) - один запрос к БД
+    QList<Car> findAvailableCars(const QDate& startDate, const QDate& endDate,
+                                 const QString& brand, double maxPrice);
     QList<Rental> searchRentalsByClientName(const QString& clientName);
     QList<Rental> searchRentalsByDate(const QDate& date);
     QList<Rental> searchRentalsByDateRange(const QDate& startDate, const QDate& endDate);
     QList<Rental> searchRentalsByCarBrand(const QString& brand);
+    
+    // Поиск аренд по тексту: клиент - по логину и ФИО, автомобиль - по марке и модели.
+    // С FTS5 совпадение по началу слов через индекс rental_search_fts, без него - подстрока через LIKE.
+    // Пустой критерий не применяется
+    QList<Rental> searchRentalsByText(const QString& clientText, const QString& carText);
+    bool hasRentalSearchIndex() const { return m_hasRentalSearchIndex; }
+    
+    // Поиск аренд по всем критериям одним запросом (см. RentalQueryBuilder)
+    QList<Rental> searchRentals(const RentalSearchCriteria& criteria);
+    // Страница результатов от новых аренд к старым: до pageSize строк после курсора
+    RentalPage searchRentalsPage(const RentalSearchCriteria& criteria,
+                                 const RentalPageCursor& cursor, int pageSize);
+    
+    // Потоковый обход таблиц без материализации списка: строки читаются
+    // forward-only курсором и передаются в callback по одной.
+    // callback возвращает false, чтобы остановить обход. Возвращает false при ошибке запроса
+    bool forEachUser(const RowFilter& filter, const std::function<bool(const User&)>& callback);
+    bool forEachCar(const RowFilter& filter, const std::function<bool(const Car&)>& callback);
+    bool forEachRental(const RowFilter& filter, const std::function<bool(const Rental&)>& callback);
+    bool forEachFine(const RowFilter& filter, const std::function<bool(const Fine&)>& callback);
+    
+    // Кэш подготовленных запросов (ключ - текст SQL); счетчики общие для всех потоков,
+    // размер и очистка относятся к кэшу основного соединения
+    int getStatementCacheHits() const { return m_statementCacheHits.load(); }
+    int getStatementCacheMisses() const { return m_statementCacheMisses.load(); }
+    int getStatementCacheSize() const { return m_statementCache.size(); }
+    void clearStatementCache();
+    
+    // Кэш автомобилей и пользователей по ID (попадания, промахи, доля попаданий)
+    const EntityCache<Car>& getCarCache() const { return m_carCache; }
+    const EntityCache<User>& getUserCache() const { return m_userCache; }
+    
+    // Периоды активных аренд по автомобилям (проверка доступности без запросов к БД)
+    const BookingIndex& getBookingIndex() const { return m_bookingIndex; }
+    
+    // Экранирование %, _ и \ для LIKE ... ESCAPE '\'
+    static QString escapeLike(const QString& text);
+    
+    // Ошибка SQLITE_BUSY или SQLITE_LOCKED: блокировку держит другое соединение
+    static bool isBusyError(const QSqlError& error);
 
 private:
     DatabaseManager();
@@ -68,8 +193,109 @@ private:
     DatabaseManager& operator=(const DatabaseManager&) = delete;
     
     QSqlDatabase m_database;
+    DatabaseConfig m_config;
+    QString m_settingsPath;
+    QThread* m_ownerThread;
+    ConnectionPool m_pool;
+    QHash<QString, QSqlQuery*> m_statementCache;
+    QAtomicInt m_statementCacheHits;
+    QAtomicInt m_statementCacheMisses;
+    bool m_hasRentalSearchIndex;
+    
+    // Соединение и кэш запросов текущего потока
+    bool isOwnerThread() const { return QThread::currentThread() == m_ownerThread; }
+    QSqlDatabase currentConnection();
+    QHash<QString, QSqlQuery*>& currentStatementCache();
+    // Возвращает подготовленный запрос из кэша (prepare выполняется один раз на текст SQL)
+    QSqlQuery& cachedQuery(const QString& sql);
+    template<typename T>
+    bool forEachRow(const RowFilter& filter, const std::function<bool(const T&)>& callback);
+    // Оценка числа строк таблицы для резервирования результата (не больше TABLE_SIZE_HINT_LIMIT)
+    static const int TABLE_SIZE_HINT_LIMIT = 65536;
+    int tableSizeHint(const QString& table);
     bool createTables();
-    int getNextAvailableUserId();
+    
+    // Коды результата SQLite (sqlite3.h в поставке Qt не входит)
+    static const int SQLITE_BUSY_CODE = 5;
+    static const int SQLITE_LOCKED_CODE = 6;
+    
+    // Условие текстового поиска по колонке с параметрами
+    static void appendTextFilter(const QString& column, const QString& text, CarSearchMode mode,
+                                 QStringList& conditions, QVariantList& values);
+    // Границы [lower, upper) для префиксного поиска по колонке с COLLATE NOCASE
+    static bool prefixRange(const QString& prefix, QString* lowerBound, QString* upperBound);
+    
+    // Полнотекстовый индекс аренд (FTS5), если модуль доступен в сборке SQLite
+    bool ensureRentalSearchIndex();
+    
+    // Миграции схемы: каждая миграция поднимает user_version на единицу
+    static const int SCHEMA_VERSION = 8;
+    bool migrateSchema();
+    bool applyMigration(int version);
+    bool execStatements(const QStringList& statements);
+    
+    // Точки сохранения SQLite: вне транзакции SAVEPOINT открывает ее, а RELEASE фиксирует,
+    // внутри транзакции (импорт, пакетная операция) - вложенная часть, которую можно откатить отдельно
+    bool beginSavepoint(const QString& name);
+    bool releaseSavepoint(const QString& name);
+    void rollbackToSavepoint(const QString& name);
+    
+    // Write-through кэш по ID: заполняется при чтении, обновляется при изменениях через
+    // DatabaseManager. Изменения внутри транзакции попадают в кэш только после ее фиксации:
+    // до этого записи удаляются из кэша, а их ID запоминаются в состоянии транзакции потока
+    static const int ENTITY_CACHE_CAPACITY = 10000;
+    // Не больше параметров в одном запросе, чем допускает SQLite (SQLITE_MAX_VARIABLE_NUMBER = 999)
+    static const int CAR_STATUS_CHUNK_SIZE = 500;
+    // Обновить статус в кэше, если автомобиль там есть
+    void updateCachedCarStatus(int carId, CarStatus status, quint64 generation);
+    // Записанная строка: вне транзакции - в кэш (EntityCache::publish), внутри - удаление до фиксации
+    void storeCachedCar(const Car& car, quint64 generation);
+    void storeCachedUser(const User& user, quint64 generation);
+    void invalidateCachedCar(int carId);
+    void invalidateCachedUser(int userId);
+    EntityCache<Car> m_carCache;
+    EntityCache<User> m_userCache;
+    
+    // Изменения других процессов (пакетный режим) видны по ревизии entities_revision, которую
+    // увеличивают триггеры на cars и users. Ревизия проверяется при чтении по ID не чаще
+    // ENTITY_REVISION_CHECK_MS; собственные записи тоже ее меняют, поэтому после них кэш
+    // один раз очищается целиком
+    static const int ENTITY_REVISION_CHECK_MS = 1000;
+    void checkEntityRevision();
+    QAtomicInt m_entityRevision;
+    QMutex m_entityRevisionMutex;
+    QElapsedTimer m_entityRevisionTimer;
+    
+    // Открытая транзакция текущего потока (BEGIN или точки сохранения) и ID, измененные в ней
+    struct TransactionState {
+        int depth;
+        QSet<int> carIds;
+        QSet<int> userIds;
+        
+        TransactionState() : depth(0) {}
+    };
+    QThreadStorage<TransactionState*> m_transactions;
+    TransactionState& currentTransaction();
+    bool inTransaction();
+    void enterTransaction();
+    // Выход из уровня транзакции (all - из всех уровней: COMMIT, ROLLBACK); после внешнего
+    // уровня записи, измененные в транзакции, удаляются из кэша
+    void leaveTransaction(bool all = false);
+    
+    // Индекс активных аренд: загружается при открытии БД и обновляется в add/update/deleteRental
+    BookingIndex m_bookingIndex;
+    bool loadBookingIndex();
+    
+    // ID пользователей: наименьший свободный или следующий после максимального (см. UserIdAllocator)
+    // Загрузка сверяет состояние с таблицей users; вызывается при открытии БД, после отката
+    // транзакции и при конфликте ID в addUser
+    UserIdAllocator m_userIds;
+    static const int USER_ID_CONFLICT_RETRIES = 3;
+    bool loadUserIdAllocator();
+    // Запись распределителя в БД; вызываются внутри точки сохранения вместе с изменением users
+    bool allocateUserId(int* userId);
+    bool releaseUserId(int userId);
+    bool userIdExists(int userId);
 };
 
 #endif // DATABASEMANAGER_H
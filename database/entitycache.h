@@ -0,0 +1,150 @@
+#ifndef ENTITYCACHE_H
+#define ENTITYCACHE_H
+
+#include <QHash>
+#include <QReadWriteLock>
+#include <QReadLocker>
+#include <QWriteLocker>
+#include <QAtomicInt>
+#include <QList>
+#include <functional>
+
+// Кэш сущностей по ID перед DatabaseManager (write-through): чтение по ID сначала ищет здесь,
+// а зафиксированные изменения через DatabaseManager записываются и в БД, и в кэш.
+// Потокобезопасен: поиск под блокировкой чтения, изменения - под блокировкой записи.
+// Каждое изменение увеличивает поколение кэша. Поток запоминает поколение до обращения к БД
+// и передает его при записи в кэш: если кэш за это время менялся, порядок записей неизвестен,
+// и устаревшее значение не попадает в кэш.
+// При переполнении вытесняется произвольная запись
+template<typename T>
+class EntityCache
+{
+public:
+    explicit EntityCache(int capacity)
+        : m_capacity(capacity), m_generation(0), m_hits(0), m_misses(0) {}
+    
+    // Найти запись. Счетчики попаданий/промахов обновляются при каждом вызове
+    bool find(int id, T* entity) const
+    {
+        QReadLocker locker(&m_lock);
+        typename QHash<int, T>::const_iterator it = m_entries.constFind(id);
+        if (it == m_entries.constEnd()) {
+            m_misses.ref();
+            return false;
+        }
+        m_hits.ref();
+        *entity = it.value();
+        return true;
+    }
+    
+    // Поколение кэша - запоминается перед чтением или записью в БД
+    quint64 getGeneration() const
+    {
+        QReadLocker locker(&m_lock);
+        return m_generation;
+    }
+    
+    // Заполнение прочитанной из БД строкой: только если кэш не менялся с поколения generation
+    void fill(int id, const T& entity, quint64 generation)
+    {
+        QWriteLocker locker(&m_lock);
+        if (m_generation == generation) {
+            store(id, entity);
+        }
+    }
+    
+    void fillAll(const QList<T>& entities, quint64 generation)
+    {
+        QWriteLocker locker(&m_lock);
+        if (m_generation != generation) {
+            return;
+        }
+        for (const T& entity : entities) {
+            store(entity.getId(), entity);
+        }
+    }
+    
+    // Значение, записанное в БД и зафиксированное. Если кэш менялся с поколения generation,
+    // другой поток мог записать эту же строку - запись удаляется, следующее чтение возьмет ее из БД
+    void publish(int id, const T& entity, quint64 generation)
+    {
+        QWriteLocker locker(&m_lock);
+        if (m_generation == generation) {
+            store(id, entity);
+        } else {
+            m_entries.remove(id);
+        }
+        m_generation++;
+    }
+    
+    // Изменение части полей записи (если она есть в кэше) по тем же правилам, что и publish
+    void modify(int id, const std::function<void(T&)>& change, quint64 generation)
+    {
+        QWriteLocker locker(&m_lock);
+        typename QHash<int, T>::iterator it = m_entries.find(id);
+        if (it != m_entries.end()) {
+            if (m_generation == generation) {
+                change(it.value());
+            } else {
+                m_entries.erase(it);
+            }
+        }
+        m_generation++;
+    }
+    
+    void remove(int id)
+    {
+        QWriteLocker locker(&m_lock);
+        m_entries.remove(id);
+        m_generation++;
+    }
+    
+    void clear()
+    {
+        QWriteLocker locker(&m_lock);
+        m_entries.clear();
+        m_generation++;
+    }
+    
+    int getSize() const
+    {
+        QReadLocker locker(&m_lock);
+        return m_entries.size();
+    }
+    int getCapacity() const { return m_capacity; }
+    int getHits() const { return m_hits.load(); }
+    int getMisses() const { return m_misses.load(); }
+    
+    // Доля попаданий среди всех обращений (0, если обращений не было)
+    double getHitRatio() const
+    {
+        int hits = m_hits.load();
+        int total = hits + m_misses.load();
+        return total > 0 ? static_cast<double>(hits) / total : 0.0;
+    }
+    
+    void resetStats()
+    {
+        m_hits.store(0);
+        m_misses.store(0);
+    }
+
+private:
+    // Вызывается под блокировкой записи
+    void store(int id, const T& entity)
+    {
+        if (!m_entries.contains(id) && m_entries.size() >= m_capacity && !m_entries.isEmpty()) {
+            m_entries.erase(m_entries.begin());
+        }
+        m_entries.insert(id, entity);
+    }
+    
+    int m_capacity;
+    mutable QReadWriteLock m_lock;
+    QHash<int, T> m_entries;
+    quint64 m_generation;
+    mutable QAtomicInt m_hits;
+    mutable QAtomicInt m_misses;
+};
+
+#endif // ENTITYCACHE_H
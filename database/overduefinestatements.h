@@ -0,0 +1,56 @@
+#ifndef OVERDUEFINESTATEMENTS_H
+#define OVERDUEFINESTATEMENTS_H
+
+#include <QDate>
+#include <QString>
+#include <QVariantList>
+
+// Пересчет штрафов за просрочку всех активных аренд двумя запросами вместо цикла по арендам.
+// Семантика совпадает с RentalService::calculateFine: сумма = цена в день * множитель * дни
+// просрочки, дата штрафа - today; у аренды обновляется первый штраф с датой не раньше окончания,
+// а если такого нет - добавляется новый. Аренды с нулевой суммой штрафа пропускаются.
+// Даты в БД - номера юлианских дней, поэтому дни просрочки - разность целых.
+
+// Обновление существующих штрафов, сумма которых изменилась.
+// SQLite 3.27 (Qt 5.12) не поддерживает UPDATE ... FROM - значения берутся коррелированными подзапросами
+inline QString overdueFineUpdateSql()
+{
+    return QString(
+        "UPDATE fines SET "
+        "amount = (SELECT c.daily_price * ? * (? - r.end_date) FROM rentals r JOIN cars c ON c.id = r.car_id "
+        "WHERE r.id = fines.rental_id), "
+        "date = ?, "
+        "reason = (SELECT 'Просрочка возврата на ' || (? - r.end_date) || ' день(ей)' FROM rentals r "
+        "WHERE r.id = fines.rental_id) "
+        "WHERE id IN ("
+        "SELECT f.id FROM rentals r JOIN cars c ON c.id = r.car_id "
+        "JOIN fines f ON f.id = (SELECT MIN(f2.id) FROM fines f2 WHERE f2.rental_id = r.id AND f2.date >= r.end_date) "
+        "WHERE r.is_completed = 0 AND r.end_date < ? AND c.daily_price > 0 "
+        "AND abs(f.amount - c.daily_price * ? * (? - r.end_date)) > 0.005)");
+}
+
+inline QVariantList overdueFineUpdateValues(const QDate& today, double multiplier)
+{
+    const qint64 day = today.toJulianDay();
+    return QVariantList() << multiplier << day << day << day << day << multiplier << day;
+}
+
+// Новые штрафы для просроченных аренд, у которых штрафа за просрочку еще нет
+inline QString overdueFineInsertSql()
+{
+    return QString(
+        "INSERT INTO fines (rental_id, amount, date, reason) "
+        "SELECT r.id, c.daily_price * ? * (? - r.end_date), ?, "
+        "'Просрочка возврата на ' || (? - r.end_date) || ' день(ей)' "
+        "FROM rentals r JOIN cars c ON c.id = r.car_id "
+        "WHERE r.is_completed = 0 AND r.end_date < ? AND c.daily_price > 0 "
+        "AND NOT EXISTS (SELECT 1 FROM fines f WHERE f.rental_id = r.id AND f.date >= r.end_date)");
+}
+
+inline QVariantList overdueFineInsertValues(const QDate& today, double multiplier)
+{
+    const qint64 day = today.toJulianDay();
+    return QVariantList() << multiplier << day << day << day << day;
+}
+
+#endif // OVERDUEFINESTATEMENTS_H
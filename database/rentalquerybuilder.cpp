@@ -0,0 +1,162 @@
+#include "rentalquerybuilder.h"
+#include "databasemanager.h"
+#include "rowmapper.h"
+
+RentalQueryBuilder::RentalQueryBuilder(bool useFullTextIndex)
+    : m_useFullTextIndex(useFullTextIndex), m_joinUsers(false), m_joinCars(false), m_limit(0)
+{
+}
+
+RentalQueryBuilder& RentalQueryBuilder::where(const RentalSearchCriteria& criteria)
+{
+    addTextCriteria(criteria.clientText, criteria.carText);
+    
+    // Аренда пересекается с периодом: start_date <= dateTo AND end_date >= dateFrom.
+    // Перепутанные границы меняем местами, открытая граница не ограничивает
+    QDate from = criteria.dateFrom;
+    QDate to = criteria.dateTo;
+    if (from.isValid() && to.isValid() && from > to) {
+        qSwap(from, to);
+    }
+    if (to.isValid()) {
+        m_conditions << "r.start_date <= ?";
+        m_values << dateToDb(to);
+    }
+    if (from.isValid()) {
+        m_conditions << "r.end_date >= ?";
+        m_values << dateToDb(from);
+    }
+    
+    if (criteria.status == RentalStatusFilter::Active) {
+        m_conditions << "r.is_completed = 0";
+    } else if (criteria.status == RentalStatusFilter::Completed) {
+        m_conditions << "r.is_completed = 1";
+    }
+    return *this;
+}
+
+RentalQueryBuilder& RentalQueryBuilder::where(const QString& condition, const QVariantList& values)
+{
+    m_conditions << condition;
+    m_values << values;
+    return *this;
+}
+
+RentalQueryBuilder& RentalQueryBuilder::orderBy(const QString& order)
+{
+    m_orderBy = order;
+    return *this;
+}
+
+RentalQueryBuilder& RentalQueryBuilder::limit(int count)
+{
+    m_limit = count;
+    return *this;
+}
+
+RentalQueryBuilder& RentalQueryBuilder::after(const RentalPageCursor& cursor)
+{
+    orderBy("r.start_date DESC, r.id DESC");
+    if (cursor.isValid()) {
+        // Сравнение пар значений проходит по индексу (start_date, id) без OFFSET:
+        // стоимость страницы не зависит от ее номера
+        m_conditions << "(r.start_date, r.id) < (?, ?)";
+        m_values << dateToDb(cursor.startDate) << cursor.rentalId;
+    }
+    return *this;
+}
+
+RentalQueryBuilder& RentalQueryBuilder::withDetails()
+{
+    m_joinUsers = true;
+    m_joinCars = true;
+    return *this;
+}
+
+QString RentalQueryBuilder::selectSql(const QString& columns) const
+{
+    QString sql = QString("SELECT %1 FROM rentals r").arg(columns);
+    if (m_joinUsers) {
+        sql += " LEFT JOIN users u ON r.user_id = u.id";
+    }
+    if (m_joinCars) {
+        sql += " LEFT JOIN cars c ON r.car_id = c.id";
+    }
+    if (!m_conditions.isEmpty()) {
+        sql += " WHERE " + m_conditions.join(" AND ");
+    }
+    if (!m_orderBy.isEmpty()) {
+        sql += " ORDER BY " + m_orderBy;
+    }
+    if (m_limit > 0) {
+        sql += " LIMIT ?";
+    }
+    return sql;
+}
+
+QVariantList RentalQueryBuilder::getBindValues() const
+{
+    QVariantList values = m_values;
+    if (m_limit > 0) {
+        values << m_limit;
+    }
+    return values;
+}
+
+void RentalQueryBuilder::addTextCriteria(const QString& clientText, const QString& carText)
+{
+    if (m_useFullTextIndex) {
+        QString clientQuery = ftsPrefixQuery("{username full_name}", clientText);
+        QString carQuery = ftsPrefixQuery("{brand model}", carText);
+        // Текст без букв и цифр не дает токенов FTS - такой поиск выполняется через LIKE
+        bool indexable = (clientText.trimmed().isEmpty() || !clientQuery.isEmpty()) &&
+                         (carText.trimmed().isEmpty() || !carQuery.isEmpty());
+        if (indexable) {
+            QStringList matchTerms;
+            if (!clientQuery.isEmpty()) matchTerms << clientQuery;
+            if (!carQuery.isEmpty()) matchTerms << carQuery;
+            if (!matchTerms.isEmpty()) {
+                m_conditions << "r.id IN (SELECT rowid FROM rental_search_fts WHERE rental_search_fts MATCH ?)";
+                m_values << matchTerms.join(" AND ");
+            }
+            return;
+        }
+    }
+    
+    // Без FTS5: подстрока в тех же колонках (полный просмотр)
+    if (!clientText.isEmpty()) {
+        QString pattern = "%" + DatabaseManager::escapeLike(clientText) + "%";
+        m_conditions << "(u.username LIKE ? ESCAPE '\\' OR u.full_name LIKE ? ESCAPE '\\')";
+        m_values << pattern << pattern;
+        m_joinUsers = true;
+    }
+    if (!carText.isEmpty()) {
+        QString pattern = "%" + DatabaseManager::escapeLike(carText) + "%";
+        m_conditions << "(c.brand LIKE ? ESCAPE '\\' OR c.model LIKE ? ESCAPE '\\')";
+        m_values << pattern << pattern;
+        m_joinCars = true;
+    }
+}
+
+QString RentalQueryBuilder::ftsPrefixQuery(const QString& columns, const QString& text)
+{
+    // Каждое слово - отдельная фраза в кавычках с поиском по началу слова: {cols} : "слово"*.
+    // Кавычки исключают разбор операторов FTS5 (AND, NEAR, * и т.п.) во введенном тексте
+    QStringList terms;
+    for (const QString& word : text.simplified().split(' ', QString::SkipEmptyParts)) {
+        bool hasToken = false;
+        for (const QChar& ch : word) {
+            if (ch.isLetterOrNumber()) {
+                hasToken = true;
+                break;
+            }
+        }
+        if (!hasToken) {
+            continue;
+        }
+        QString quoted = word;
+        quoted.replace("\"", "\"\"");
+        terms << QString("%1 : \"%2\"*").arg(columns, quoted);
+    }
+    return terms.join(" AND ");
+}
@@ -0,0 +1,99 @@
+#ifndef RENTALQUERYBUILDER_H
+#define RENTALQUERYBUILDER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVariantList>
+#include <QDate>
+#include <QList>
+#include "../models/rentalview.h"
+
+// Фильтр по состоянию аренды
+enum class RentalStatusFilter {
+    Any,        // Все аренды
+    Active,     // Незавершенные
+    Completed   // Завершенные
+};
+
+// Критерии поиска аренд. Пустой/невалидный критерий не применяется
+struct RentalSearchCriteria
+{
+    QString clientText;     // Логин или ФИО клиента
+    QDate dateFrom;         // Аренда пересекается с периодом [dateFrom, dateTo]
+    QDate dateTo;
+    QString carText;        // Марка или модель автомобиля
+    RentalStatusFilter status;
+
+    RentalSearchCriteria() : status(RentalStatusFilter::Any) {}
+
+    bool isEmpty() const
+    {
+        return clientText.isEmpty() && carText.isEmpty() && !dateFrom.isValid() && !dateTo.isValid() &&
+               status == RentalStatusFilter::Any;
+    }
+};
+
+// Позиция в выдаче, упорядоченной по (start_date DESC, id DESC): последняя строка предыдущей страницы.
+// Невалидный курсор - первая страница
+struct RentalPageCursor
+{
+    QDate startDate;
+    int rentalId;
+
+    RentalPageCursor() : rentalId(0) {}
+    RentalPageCursor(const QDate& startDate, int rentalId) : startDate(startDate), rentalId(rentalId) {}
+
+    bool isValid() const { return rentalId > 0 && startDate.isValid(); }
+};
+
+// Страница результатов поиска аренд (с данными для отображения)
+struct RentalPage
+{
+    QList<RentalView> rentals;
+    bool hasMore;               // Есть следующая страница
+    RentalPageCursor next;      // Курсор для запроса следующей страницы
+    int totalEstimate;          // Оценка общего числа найденных аренд (-1 - не вычислялась)
+
+    RentalPage() : hasMore(false), totalEstimate(-1) {}
+};
+
+// Построитель одного параметризованного запроса по таблице rentals (псевдоним r).
+// Все критерии объединяются в WHERE, JOIN с users/cars добавляются только когда нужны условию,
+// поэтому фильтрация выполняется в БД, а разбираются только подходящие строки.
+// Текст запроса зависит от набора критериев, а не от их значений, и попадает в кэш подготовленных запросов
+class RentalQueryBuilder
+{
+public:
+    // useFullTextIndex - текстовые критерии через FTS5-индекс rental_search_fts, иначе через LIKE
+    explicit RentalQueryBuilder(bool useFullTextIndex);
+    
+    RentalQueryBuilder& where(const RentalSearchCriteria& criteria);
+    // Произвольное дополнительное условие с позиционными параметрами
+    RentalQueryBuilder& where(const QString& condition, const QVariantList& values = QVariantList());
+    RentalQueryBuilder& orderBy(const QString& order);
+    RentalQueryBuilder& limit(int count);
+    // Keyset-пагинация: строки после курсора в порядке (start_date DESC, id DESC)
+    RentalQueryBuilder& after(const RentalPageCursor& cursor);
+    // Подключить users (u) и cars (c) для выборки колонок RowMapper<RentalView>
+    RentalQueryBuilder& withDetails();
+    
+    // "SELECT <columns> FROM rentals r [JOIN ...] [WHERE ...] [ORDER BY ...] [LIMIT ?]"
+    QString selectSql(const QString& columns) const;
+    QVariantList getBindValues() const;
+
+    // Выражение FTS5 MATCH: все слова текста как префиксы в указанных колонках
+    static QString ftsPrefixQuery(const QString& columns, const QString& text);
+
+private:
+    void addTextCriteria(const QString& clientText, const QString& carText);
+    
+    bool m_useFullTextIndex;
+    bool m_joinUsers;
+    bool m_joinCars;
+    QStringList m_conditions;
+    QVariantList m_values;
+    QString m_orderBy;
+    int m_limit;
+};
+
+#endif // RENTALQUERYBUILDER_H
@@ -0,0 +1,206 @@
+#ifndef ROWMAPPER_H
+#define ROWMAPPER_H
+
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QVariant>
+#include <QVariantList>
+#include <QString>
+#include <QList>
+#include <QDate>
+#include <QDebug>
+#include "../models/user.h"
+#include "../models/car.h"
+#include "../models/rental.h"
+#include "../models/fine.h"
+#include "../models/rentalview.h"
+
+// Даты хранятся в БД как номер юлианского дня (QDate::toJulianDay):
+// чтение не требует разбора строки, а сравнение диапазонов идет по целым числам
+inline QVariant dateToDb(const QDate& date)
+{
+    return date.isValid() ? QVariant(date.toJulianDay()) : QVariant();
+}
+
+inline QDate dateFromDb(const QVariant& value)
+{
+    return value.isNull() ? QDate() : QDate::fromJulianDay(value.toLongLong());
+}
+
+// Отображение строки результата на модель.
+// columns() задает явный список колонок вместо SELECT *, а map() читает их
+// по тем же позициям, поэтому порядок в обоих местах должен совпадать.
+// qualifiedColumns() - тот же список с псевдонимом таблицы для запросов с JOIN.
+template<typename T>
+struct RowMapper;
+
+template<>
+struct RowMapper<User>
+{
+    static const char* table() { return "users"; }
+    static const char* columns() { return "id, username, password, full_name, role"; }
+    static const char* qualifiedColumns() { return "u.id, u.username, u.password, u.full_name, u.role"; }
+
+    static User map(const QSqlQuery& query)
+    {
+        return User(query.value(0).toInt(),
+                    query.value(1).toString(),
+                    query.value(2).toString(),
+                    query.value(3).toString(),
+                    static_cast<UserRole>(query.value(4).toInt()));
+    }
+};
+
+template<>
+struct RowMapper<Car>
+{
+    static const char* table() { return "cars"; }
+    static const char* columns() { return "id, brand, model, status, daily_price"; }
+    static const char* qualifiedColumns() { return "c.id, c.brand, c.model, c.status, c.daily_price"; }
+
+    static Car map(const QSqlQuery& query)
+    {
+        return Car(query.value(0).toInt(),
+                   query.value(1).toString(),
+                   query.value(2).toString(),
+                   static_cast<CarStatus>(query.value(3).toInt()),
+                   query.value(4).toDouble());
+    }
+};
+
+template<>
+struct RowMapper<Rental>
+{
+    static const char* table() { return "rentals"; }
+    static const char* columns()
+    {
+        return "id, car_id, user_id, start_date, end_date, actual_return_date, total_cost, is_completed";
+    }
+    static const char* qualifiedColumns()
+    {
+        return "r.id, r.car_id, r.user_id, r.start_date, r.end_date, r.actual_return_date, r.total_cost, r.is_completed";
+    }
+
+    static Rental map(const QSqlQuery& query)
+    {
+        Rental rental(query.value(0).toInt(),
+                      query.value(1).toInt(),
+                      query.value(2).toInt(),
+                      dateFromDb(query.value(3)),
+                      dateFromDb(query.value(4)),
+                      query.value(6).toDouble(),
+                      query.value(7).toInt() == 1);
+        rental.setActualReturnDate(dateFromDb(query.value(5)));
+        return rental;
+    }
+};
+
+template<>
+struct RowMapper<Fine>
+{
+    static const char* table() { return "fines"; }
+    static const char* columns() { return "id, rental_id, amount, date, reason"; }
+    static const char* qualifiedColumns() { return "f.id, f.rental_id, f.amount, f.date, f.reason"; }
+
+    static Fine map(const QSqlQuery& query)
+    {
+        return Fine(query.value(0).toInt(),
+                    query.value(1).toInt(),
+                    query.value(2).toDouble(),
+                    dateFromDb(query.value(3)),
+                    query.value(4).toString());
+    }
+};
+
+// Аренда с данными для отображения. Запрос: FROM rentals r LEFT JOIN users u LEFT JOIN cars c;
+// сумма штрафов - коррелированный подзапрос по индексу idx_fines_rental_id
+template<>
+struct RowMapper<RentalView>
+{
+    static const char* qualifiedColumns()
+    {
+        return "r.id, r.car_id, r.user_id, r.start_date, r.end_date, r.actual_return_date, r.total_cost, r.is_completed, "
+               "u.username, c.brand, c.model, "
+               "(SELECT COALESCE(SUM(f.amount), 0) FROM fines f WHERE f.rental_id = r.id)";
+    }
+
+    static RentalView map(const QSqlQuery& query)
+    {
+        return RentalView(RowMapper<Rental>::map(query),
+                          query.value(8).toString(),
+                          query.value(9).toString(),
+                          query.value(10).toString(),
+                          query.value(11).toDouble());
+    }
+};
+
+// Условие отбора для потокового обхода: фрагмент WHERE с позиционными параметрами.
+// Пустое условие - вся таблица
+struct RowFilter
+{
+    QString condition;
+    QVariantList bindValues;
+
+    RowFilter() {}
+    RowFilter(const QString& condition, const QVariantList& bindValues = QVariantList())
+        : condition(condition), bindValues(bindValues) {}
+};
+
+// "SELECT <колонки> FROM <таблица> <условие>"
+template<typename T>
+QString selectSql(const QString& tail = QString())
+{
+    QString sql = QString("SELECT %1 FROM %2").arg(RowMapper<T>::columns(), RowMapper<T>::table());
+    if (!tail.isEmpty()) {
+        sql += " " + tail;
+    }
+    return sql;
+}
+
+// Выполнить подготовленный запрос и разобрать все строки.
+// sizeHint - ожидаемое число строк для резервирования списка (SQLite не сообщает size())
+template<typename T>
+QList<T> fetchAll(QSqlQuery& query, int sizeHint = 0)
+{
+    QList<T> items;
+    if (!query.exec()) {
+        qDebug() << "Ошибка выполнения запроса:" << query.lastError().text();
+        return items;
+    }
+
+    int size = query.size();
+    items.reserve(size > 0 ? size : sizeHint);
+    while (query.next()) {
+        items.append(RowMapper<T>::map(query));
+    }
+    return items;
+}
+
+// Разобрать строки уже выполненного запроса по одной, не накапливая их.
+// Обход прекращается, если visitor вернул false
+template<typename T, typename Visitor>
+int visitRows(QSqlQuery& query, Visitor visitor)
+{
+    int visited = 0;
+    while (query.next()) {
+        visited++;
+        if (!visitor(RowMapper<T>::map(query))) {
+            break;
+        }
+    }
+    return visited;
+}
+
+// Выполнить подготовленный запрос и разобрать первую строку
+template<typename T>
+T fetchOne(QSqlQuery& query)
+{
+    T item;
+    if (query.exec() && query.next()) {
+        item = RowMapper<T>::map(query);
+    }
+    query.finish();
+    return item;
+}
+
+#endif // ROWMAPPER_H
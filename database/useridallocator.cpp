@@ -0,0 +1,60 @@
+#include "useridallocator.h"
+#include <QMutexLocker>
+
+UserIdAllocator::UserIdAllocator()
+    : m_highWater(1), m_loaded(false)
+{
+}
+
+void UserIdAllocator::load(const QList<int>& holes, int highWater)
+{
+    QMutexLocker locker(&m_mutex);
+    m_highWater = qMax(1, highWater);
+    m_holes.clear();
+    for (int id : holes) {
+        // Дыра не может быть на границе или выше - такой ID и так будет выдан по границе
+        if (id > 0 && id < m_highWater) {
+            m_holes.insert(id);
+        }
+    }
+    m_loaded = true;
+}
+
+bool UserIdAllocator::isLoaded() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_loaded;
+}
+
+int UserIdAllocator::reserve(bool* fromHole)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_holes.empty()) {
+        int id = *m_holes.begin();
+        m_holes.erase(m_holes.begin());
+        if (fromHole) *fromHole = true;
+        return id;
+    }
+    if (fromHole) *fromHole = false;
+    return m_highWater++;
+}
+
+void UserIdAllocator::release(int id)
+{
+    QMutexLocker locker(&m_mutex);
+    if (id > 0 && id < m_highWater) {
+        m_holes.insert(id);
+    }
+}
+
+int UserIdAllocator::getHighWater() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_highWater;
+}
+
+int UserIdAllocator::getHoleCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return static_cast<int>(m_holes.size());
+}
@@ -0,0 +1,37 @@
+#ifndef USERIDALLOCATOR_H
+#define USERIDALLOCATOR_H
+
+#include <QList>
+#include <QMutex>
+#include <set>
+
+// Распределитель ID пользователей: выдает наименьший свободный ID ("дыру" после удаления)
+// или, если дыр нет, следующий после максимального (верхняя граница, high water).
+// Состояние хранится в БД (user_id_holes, id_allocator) и загружается в память один раз,
+// поэтому выделение не требует запросов к таблице users. Потокобезопасен.
+class UserIdAllocator
+{
+public:
+    UserIdAllocator();
+    
+    // Загрузить состояние: список дыр и верхнюю границу (первый никогда не выдававшийся ID)
+    void load(const QList<int>& holes, int highWater);
+    bool isLoaded() const;
+    
+    // Выделить ID. fromHole = true, если ID взят из списка дыр, иначе граница сдвинута на единицу
+    int reserve(bool* fromHole);
+    
+    // Вернуть ID в список свободных (удаление пользователя или неудачная вставка)
+    void release(int id);
+    
+    int getHighWater() const;
+    int getHoleCount() const;
+
+private:
+    mutable QMutex m_mutex;
+    std::set<int> m_holes;
+    int m_highWater;
+    bool m_loaded;
+};
+
+#endif // USERIDALLOCATOR_H
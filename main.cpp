@@ -2,12 +2,21 @@
 #include "ui/clientmainwindow.h"
 #include "ui/adminmainwindow.h"
 #include "database/databasemanager.h"
-#include "services/rentalservice.h"
+#include "services/maintenancescheduler.h"
+#include "cli/batchrunner.h"
+#include <QCoreApplication>
 #include <QApplication>
 #include <QDebug>
 
 int main(int argc, char *argv[])
 {
+    // Пакетный режим (--batch) работает без дисплея: только QCoreApplication, без окон
+    if (BatchRunner::isBatchInvocation(argc, argv)) {
+        QCoreApplication app(argc, argv);
+        BatchRunner runner;
+        return runner.run(app);
+    }
+    
     QApplication a(argc, argv);
     
     // Инициализация базы данных
@@ -17,9 +26,11 @@ int main(int argc, char *argv[])
         return -1;
     }
     
-    // Автоматическая проверка просроченных аренд и начисление штрафов
-    RentalService rentalService;
-    rentalService.checkAndApplyOverdueFines();
+    // Фоновое обслуживание: штрафы за просрочку (первый проход сразу после запуска),
+    // предварительный расчет отчетов, ANALYZE/VACUUM. Интервалы - секция [maintenance] database.ini
+    MaintenanceScheduler scheduler(MaintenanceConfig::load(db.getSettingsPath()));
+    scheduler.addDefaultJobs();
+    scheduler.start();
     
     // Показываем окно входа
     LoginWindow loginWindow;
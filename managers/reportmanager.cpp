@@ -1,8 +1,34 @@
 #include "reportmanager.h"
+#include "../utils/dateutils.h"
 #include <QMap>
+#include <QHash>
 #include <QDebug>
+#include <QMutex>
+#include <QMutexLocker>
 #include <algorithm>
 
+namespace {
+
+// Кэш отчетов за период, общий для всех копий ReportManager (отчеты строятся в фоновых потоках)
+struct CachedReport {
+    int revision;
+    PeriodReport report;
+};
+
+const int REPORT_CACHE_CAPACITY = 16;
+QMutex reportCacheMutex;
+QHash<QString, CachedReport> reportCache;
+
+// Длительность незавершенных аренд считается до текущей даты (Rental::getDaysRented),
+// поэтому отчет, рассчитанный вчера, сегодня устарел даже без изменения данных
+QString reportCacheKey(const QDate& startDate, const QDate& endDate, int popularLimit)
+{
+    return QString("%1:%2:%3:%4").arg(startDate.toJulianDay()).arg(endDate.toJulianDay()).arg(popularLimit)
+        .arg(DateUtils::currentDate().toJulianDay());
+}
+
+}
+
 ReportManager::ReportManager()
     : m_dbManager(nullptr)
 {
@@ -23,47 +49,40 @@ RevenueReport ReportManager::generateRevenueReport(const QDate& startDate, const
         return report;
     }
     
-    // Получаем все аренды за период
-    QList<Rental> allRentals = m_dbManager->getAllRentals();
-    QList<Rental> periodRentals;
-    
-    for (const Rental& rental : allRentals) {
-        if (rental.getStartDate() >= startDate && rental.getStartDate() <= endDate) {
-            periodRentals.append(rental);
-        }
-    }
-    
-    report.totalRentals = periodRentals.size();
-    
-    // Рассчитываем доход от аренд
-    report.totalRevenue = calculateTotalRevenue(periodRentals);
+    // Аренды за период: один проход, без загрузки всей таблицы
+    int totalDays = 0;
+    m_dbManager->forEachRental(periodFilter("start_date", startDate, endDate),
+                               [&report, &totalDays](const Rental& rental) {
+        report.totalRentals++;
+        report.totalRevenue += rental.getTotalCost();
+        totalDays += rental.getDaysRented();
+        return true;
+    });
     
     // Рассчитываем штрафы
     report.totalFines = calculateTotalFines(startDate, endDate);
     
     // Активные аренды
-    QList<Rental> activeRentals = m_dbManager->getActiveRentals();
-    report.activeRentals = activeRentals.size();
+    m_dbManager->forEachRental(RowFilter("is_completed=0"), [&report](const Rental&) {
+        report.activeRentals++;
+        return true;
+    });
     
     // Средняя длительность аренды
-    if (!periodRentals.isEmpty()) {
-        int totalDays = 0;
-        for (const Rental& rental : periodRentals) {
-            totalDays += rental.getDaysRented();
-        }
-        report.averageRentalDuration = static_cast<double>(totalDays) / periodRentals.size();
+    if (report.totalRentals > 0) {
+        report.averageRentalDuration = static_cast<double>(totalDays) / report.totalRentals;
     }
     
     // Загруженность парка
-    QList<Car> allCars = m_dbManager->getAllCars();
-    int totalCars = allCars.size();
+    int totalCars = 0;
     int rentedCars = 0;
-    
-    for (const Car& car : allCars) {
+    m_dbManager->forEachCar(RowFilter(), [&totalCars, &rentedCars](const Car& car) {
+        totalCars++;
         if (car.getStatus() == CarStatus::Rented) {
             rentedCars++;
         }
-    }
+        return true;
+    });
     
     if (totalCars > 0) {
         report.fleetUtilization = (static_cast<double>(rentedCars) / totalCars) * 100.0;
@@ -72,6 +91,36 @@ RevenueReport ReportManager::generateRevenueReport(const QDate& startDate, const
     return report;
 }
 
+PeriodReport ReportManager::generatePeriodReport(const QDate& startDate, const QDate& endDate, int popularLimit)
+{
+    // Ревизия читается до расчета: изменения во время расчета сделают запись кэша устаревшей
+    const int revision = m_dbManager ? m_dbManager->getMaintenanceValue("reports_revision", -1) : -1;
+    const QString key = reportCacheKey(startDate, endDate, popularLimit);
+    if (revision >= 0) {
+        QMutexLocker locker(&reportCacheMutex);
+        auto cached = reportCache.constFind(key);
+        if (cached != reportCache.constEnd() && cached.value().revision == revision) {
+            return cached.value().report;
+        }
+    }
+    
+    PeriodReport report;
+    report.revenue = generateRevenueReport(startDate, endDate);
+    report.popularCars = getPopularCars(startDate, endDate, popularLimit);
+    
+    if (revision >= 0) {
+        QMutexLocker locker(&reportCacheMutex);
+        if (reportCache.size() >= REPORT_CACHE_CAPACITY && !reportCache.contains(key)) {
+            reportCache.clear();
+        }
+        CachedReport cached;
+        cached.revision = revision;
+        cached.report = report;
+        reportCache.insert(key, cached);
+    }
+    return report;
+}
+
 QList<CarStatistics> ReportManager::getCarStatistics(const QDate& startDate, const QDate& endDate)
 {
     QList<CarStatistics> statistics;
@@ -80,28 +129,31 @@ QList<CarStatistics> ReportManager::getCarStatistics(const QDate& startDate, con
         return statistics;
     }
     
-    QList<Car> allCars = m_dbManager->getAllCars();
-    QList<Rental> allRentals = m_dbManager->getAllRentals();
-    
-    for (const Car& car : allCars) {
+    // Индекс позиции автомобиля в результате, чтобы аренды раскладывались за один проход
+    QHash<int, int> indexByCarId;
+    m_dbManager->forEachCar(RowFilter(), [&statistics, &indexByCarId](const Car& car) {
         CarStatistics stats;
         stats.carId = car.getId();
         stats.carName = car.getFullName();
         stats.rentalCount = 0;
         stats.totalRevenue = 0.0;
         
-        // Подсчитываем аренды для этого автомобиля
-        for (const Rental& rental : allRentals) {
-            if (rental.getCarId() == car.getId() &&
-                rental.getStartDate() >= startDate &&
-                rental.getStartDate() <= endDate) {
-                stats.rentalCount++;
-                stats.totalRevenue += rental.getTotalCost();
-            }
-        }
-        
+        indexByCarId.insert(car.getId(), statistics.size());
         statistics.append(stats);
-    }
+        return true;
+    });
+    
+    // Подсчитываем аренды по автомобилям
+    m_dbManager->forEachRental(periodFilter("start_date", startDate, endDate),
+                               [&statistics, &indexByCarId](const Rental& rental) {
+        int index = indexByCarId.value(rental.getCarId(), -1);
+        if (index >= 0) {
+            CarStatistics& stats = statistics[index];
+            stats.rentalCount++;
+            stats.totalRevenue += rental.getTotalCost();
+        }
+        return true;
+    });
     
     return statistics;
 }
@@ -132,11 +184,10 @@ QMap<CarStatus, int> ReportManager::getCarStatusStatistics()
         return statistics;
     }
     
-    QList<Car> allCars = m_dbManager->getAllCars();
-    
-    for (const Car& car : allCars) {
+    m_dbManager->forEachCar(RowFilter(), [&statistics](const Car& car) {
         statistics[car.getStatus()]++;
-    }
+        return true;
+    });
     
     return statistics;
 }
@@ -149,25 +200,19 @@ QMap<QDate, double> ReportManager::getDailyRevenue(const QDate& startDate, const
         return dailyRevenue;
     }
     
-    QList<Rental> allRentals = m_dbManager->getAllRentals();
-    
-    for (const Rental& rental : allRentals) {
-        if (rental.getStartDate() >= startDate && rental.getStartDate() <= endDate) {
-            QDate rentalDate = rental.getStartDate();
-            dailyRevenue[rentalDate] += rental.getTotalCost();
-        }
-    }
+    m_dbManager->forEachRental(periodFilter("start_date", startDate, endDate),
+                               [&dailyRevenue](const Rental& rental) {
+        dailyRevenue[rental.getStartDate()] += rental.getTotalCost();
+        return true;
+    });
     
     return dailyRevenue;
 }
 
-double ReportManager::calculateTotalRevenue(const QList<Rental>& rentals)
+RowFilter ReportManager::periodFilter(const QString& column, const QDate& startDate, const QDate& endDate)
 {
-    double total = 0.0;
-    for (const Rental& rental : rentals) {
-        total += rental.getTotalCost();
-    }
-    return total;
+    return RowFilter(QString("%1 BETWEEN ? AND ?").arg(column),
+                     QVariantList() << dateToDb(startDate) << dateToDb(endDate));
 }
 
 double ReportManager::calculateTotalFines(const QDate& startDate, const QDate& endDate)
@@ -176,14 +221,11 @@ double ReportManager::calculateTotalFines(const QDate& startDate, const QDate& e
         return 0.0;
     }
     
-    QList<Fine> allFines = m_dbManager->getAllFines();
     double total = 0.0;
-    
-    for (const Fine& fine : allFines) {
-        if (fine.getDate() >= startDate && fine.getDate() <= endDate) {
-            total += fine.getAmount();
-        }
-    }
+    m_dbManager->forEachFine(periodFilter("date", startDate, endDate), [&total](const Fine& fine) {
+        total += fine.getAmount();
+        return true;
+    });
     
     return total;
 }
@@ -25,6 +25,12 @@ struct CarStatistics {
     double totalRevenue;
 };
 
+// Полный отчет за период: общая статистика и популярные автомобили
+struct PeriodReport {
+    RevenueReport revenue;
+    QList<CarStatistics> popularCars;
+};
+
 class ReportManager
 {
 public:
@@ -33,6 +39,14 @@ public:
     // Отчет по доходу за период
     RevenueReport generateRevenueReport(const QDate& startDate, const QDate& endDate);
     
+    // Общая статистика и топ автомобилей за период одним вызовом (для фонового формирования).
+    // Результат кэшируется до изменения аренд, штрафов или автомобилей (ревизия reports_revision)
+    // или смены текущей даты, поэтому отчет, заранее рассчитанный планировщиком, выдается без обращения к таблицам
+    PeriodReport generatePeriodReport(const QDate& startDate, const QDate& endDate,
+                                      int popularLimit = DEFAULT_POPULAR_LIMIT);
+    
+    static const int DEFAULT_POPULAR_LIMIT = 10;
+    
     // Статистика по автомобилям
     QList<CarStatistics> getCarStatistics(const QDate& startDate, const QDate& endDate);
     
@@ -48,7 +62,8 @@ public:
 private:
     DatabaseManager* m_dbManager;
     
-    double calculateTotalRevenue(const QList<Rental>& rentals);
+    // Условие "column BETWEEN startDate AND endDate" для потокового обхода
+    static RowFilter periodFilter(const QString& column, const QDate& startDate, const QDate& endDate);
     double calculateTotalFines(const QDate& startDate, const QDate& endDate);
 };
 
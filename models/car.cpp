@@ -13,7 +13,12 @@ Car::Car(int id, const QString& brand, const QString& model,
 
 QString Car::getStatusString() const
 {
-    switch (m_status) {
+    return statusToString(m_status);
+}
+
+QString Car::statusToString(CarStatus status)
+{
+    switch (status) {
     case CarStatus::Available:
         return "Доступен";
     case CarStatus::Rented:
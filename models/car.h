@@ -35,6 +35,7 @@ public:
     QString getStatusString() const;
     QString getFullName() const { return m_brand + " " + m_model; }
     static CarStatus statusFromString(const QString& status);
+    static QString statusToString(CarStatus status);
 
 private:
     int m_id;
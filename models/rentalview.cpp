@@ -0,0 +1,13 @@
+#include "rentalview.h"
+
+RentalView::RentalView()
+    : m_totalFines(0.0)
+{
+}
+
+RentalView::RentalView(const Rental& rental, const QString& username,
+                       const QString& carBrand, const QString& carModel, double totalFines)
+    : m_rental(rental), m_username(username), m_carBrand(carBrand),
+      m_carModel(carModel), m_totalFines(totalFines)
+{
+}
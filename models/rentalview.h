@@ -0,0 +1,34 @@
+#ifndef RENTALVIEW_H
+#define RENTALVIEW_H
+
+#include <QString>
+#include "rental.h"
+
+// Аренда вместе с данными для отображения: логин клиента, автомобиль и сумма штрафов.
+// Заполняется одним запросом с JOIN, поэтому таблица из N аренд не требует
+// отдельных запросов автомобиля, пользователя и штрафов для каждой строки
+class RentalView
+{
+public:
+    RentalView();
+    RentalView(const Rental& rental, const QString& username,
+               const QString& carBrand, const QString& carModel, double totalFines);
+    
+    // Getters
+    const Rental& getRental() const { return m_rental; }
+    int getId() const { return m_rental.getId(); }
+    QString getUsername() const { return m_username; }
+    QString getCarBrand() const { return m_carBrand; }
+    QString getCarModel() const { return m_carModel; }
+    QString getCarFullName() const { return m_carBrand + " " + m_carModel; }
+    double getTotalFines() const { return m_totalFines; }
+
+private:
+    Rental m_rental;
+    QString m_username;     // Пусто, если пользователь удален
+    QString m_carBrand;     // Пусто, если автомобиль удален
+    QString m_carModel;
+    double m_totalFines;
+};
+
+#endif // RENTALVIEW_H
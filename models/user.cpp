@@ -14,6 +14,11 @@ User::User(int id, const QString& username, const QString& password,
 
 QString User::getRoleString() const
 {
-    return m_role == UserRole::Administrator ? "Администратор" : "Клиент";
+    return roleToString(m_role);
+}
+
+QString User::roleToString(UserRole role)
+{
+    return role == UserRole::Administrator ? "Администратор" : "Клиент";
 }
 
@@ -33,6 +33,7 @@ public:
     bool isAdministrator() const { return m_role == UserRole::Administrator; }
     bool isClient() const { return m_role == UserRole::Client; }
     QString getRoleString() const;
+    static QString roleToString(UserRole role);
 
 private:
     int m_id;
@@ -2,6 +2,14 @@
 #include "../database/databasemanager.h"
 #include <QDebug>
 
+bool ICarStatusObserver::onCarStatusBatchChanged(const QMap<int, CarStatus>& statuses)
+{
+    for (auto it = statuses.constBegin(); it != statuses.constEnd(); ++it) {
+        onCarStatusChanged(it.key(), it.value());
+    }
+    return true;
+}
+
 CarStatusObserver::CarStatusObserver()
     : m_dbManager(nullptr)
 {
@@ -15,20 +23,34 @@ void CarStatusObserver::onCarStatusChanged(int carId, CarStatus newStatus)
         return;
     }
     
-    Car car = m_dbManager->getCarById(carId);
-    if (car.getId() == 0) {
-        qDebug() << "Автомобиль с ID" << carId << "не найден!";
-        return;
-    }
-    
-    car.setStatus(newStatus);
-    if (m_dbManager->updateCar(car)) {
-        qDebug() << "Статус автомобиля" << carId << "обновлен на" << car.getStatusString();
+    // Меняется только статус: чтение автомобиля и перезапись остальных полей не нужны
+    if (m_dbManager->updateCarStatus(carId, newStatus)) {
+        qDebug() << "Статус автомобиля" << carId << "обновлен на" << Car::statusToString(newStatus);
     } else {
         qDebug() << "Ошибка обновления статуса автомобиля" << carId;
     }
 }
 
+bool CarStatusObserver::onCarStatusBatchChanged(const QMap<int, CarStatus>& statuses)
+{
+    if (!m_dbManager) {
+        qDebug() << "DatabaseManager не инициализирован!";
+        return false;
+    }
+    
+    if (!m_dbManager->updateCarStatuses(statuses)) {
+        qDebug() << "Ошибка пакетного обновления статусов автомобилей";
+        return false;
+    }
+    qDebug() << "Обновлены статусы автомобилей:" << statuses.size();
+    return true;
+}
+
+CarStatusSubject::CarStatusSubject()
+    : m_batchDepth(0)
+{
+}
+
 void CarStatusSubject::attachObserver(ICarStatusObserver* observer)
 {
     if (observer && !m_observers.contains(observer)) {
@@ -43,6 +65,11 @@ void CarStatusSubject::detachObserver(ICarStatusObserver* observer)
 
 void CarStatusSubject::notifyStatusChanged(int carId, CarStatus newStatus)
 {
+    if (m_batchDepth > 0) {
+        m_pendingStatuses.insert(carId, newStatus);
+        return;
+    }
+    
     for (ICarStatusObserver* observer : m_observers) {
         if (observer) {
             observer->onCarStatusChanged(carId, newStatus);
@@ -50,3 +77,46 @@ void CarStatusSubject::notifyStatusChanged(int carId, CarStatus newStatus)
     }
 }
 
+
+void CarStatusSubject::beginBatch()
+{
+    m_batchDepth++;
+}
+
+bool CarStatusSubject::endBatch()
+{
+    if (m_batchDepth == 0 || --m_batchDepth > 0 || m_pendingStatuses.isEmpty()) {
+        return true;
+    }
+    
+    QMap<int, CarStatus> statuses;
+    qSwap(statuses, m_pendingStatuses);
+    bool ok = true;
+    for (ICarStatusObserver* observer : m_observers) {
+        if (observer && !observer->onCarStatusBatchChanged(statuses)) {
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+CarStatusBatch::CarStatusBatch(CarStatusSubject* subject)
+    : m_subject(subject)
+{
+    if (m_subject) {
+        m_subject->beginBatch();
+    }
+}
+
+CarStatusBatch::~CarStatusBatch()
+{
+    commit();
+}
+
+bool CarStatusBatch::commit()
+{
+    // Пакет завершается один раз: после commit() деструктор ничего не делает
+    CarStatusSubject* subject = m_subject;
+    m_subject = nullptr;
+    return subject ? subject->endBatch() : true;
+}
@@ -3,6 +3,7 @@
 
 #include "../models/car.h"
 #include <QList>
+#include <QMap>
 
 // Интерфейс наблюдателя для обновления статуса автомобиля
 class ICarStatusObserver
@@ -10,6 +11,10 @@ class ICarStatusObserver
 public:
     virtual ~ICarStatusObserver() = default;
     virtual void onCarStatusChanged(int carId, CarStatus newStatus) = 0;
+    
+    // Пакет изменений (ID автомобиля -> новый статус). По умолчанию - по одному уведомлению на автомобиль.
+    // false - пакет не применен (запись откатилась), вызывающий должен узнать об ошибке
+    virtual bool onCarStatusBatchChanged(const QMap<int, CarStatus>& statuses);
 };
 
 // Конкретный наблюдатель - обновляет статус автомобиля в базе данных
@@ -18,21 +23,54 @@ class CarStatusObserver : public ICarStatusObserver
 public:
     CarStatusObserver();
     void onCarStatusChanged(int carId, CarStatus newStatus) override;
+    bool onCarStatusBatchChanged(const QMap<int, CarStatus>& statuses) override;
 
 private:
     class DatabaseManager* m_dbManager;
 };
 
-// Субъект - класс, который уведомляет наблюдателей об изменении статуса
+// Субъект - класс, который уведомляет наблюдателей об изменении статуса.
+// Между beginBatch и endBatch изменения накапливаются (для автомобиля - последний статус)
+// и доставляются наблюдателям одним пакетом при выходе из внешнего пакета
 class CarStatusSubject
 {
 public:
+    CarStatusSubject();
+    
     void attachObserver(ICarStatusObserver* observer);
     void detachObserver(ICarStatusObserver* observer);
     void notifyStatusChanged(int carId, CarStatus newStatus);
+    
+    void beginBatch();
+    // false, если хотя бы один наблюдатель не применил пакет
+    bool endBatch();
+    bool isBatching() const { return m_batchDepth > 0; }
 
 private:
     QList<ICarStatusObserver*> m_observers;
+    int m_batchDepth;
+    QMap<int, CarStatus> m_pendingStatuses;
+};
+
+// RAII-пакет уведомлений: изменения статусов внутри области видимости
+// уходят наблюдателям одним пакетом при ее завершении или при вызове commit(),
+// который возвращает результат доставки
+//   CarStatusBatch batch(subject);
+//   ...
+//   return batch.commit();
+class CarStatusBatch
+{
+public:
+    explicit CarStatusBatch(CarStatusSubject* subject);
+    ~CarStatusBatch();
+    
+    bool commit();
+
+private:
+    CarStatusBatch(const CarStatusBatch&) = delete;
+    CarStatusBatch& operator=(const CarStatusBatch&) = delete;
+    
+    CarStatusSubject* m_subject;
 };
 
 #endif // CARSTATUSOBSERVER_H
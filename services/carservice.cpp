@@ -39,6 +39,16 @@ QList<Car> CarService::getCarsByBrand(const QString& brand)
     return m_dbManager->getCarsByBrand(brand);
 }
 
+QList<Car> CarService::findAvailableCars(const QDate& startDate, const QDate& endDate,
+                                         const QString& brand, double maxPrice)
+{
+    if (!m_dbManager || !startDate.isValid() || !endDate.isValid() || startDate > endDate) {
+        return QList<Car>();
+    }
+    
+    return m_dbManager->findAvailableCars(startDate, endDate, brand, maxPrice);
+}
+
 bool CarService::addCar(const Car& car)
 {
     if (!m_dbManager) {
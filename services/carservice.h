@@ -3,6 +3,8 @@
 
 #include "../models/car.h"
 #include <QList>
+#include <QDate>
+#include <QString>
 
 class DatabaseManager;
 
@@ -23,6 +25,12 @@ public:
     // Поиск автомобилей по марке
     QList<Car> getCarsByBrand(const QString& brand);
     
+    // Автомобили, свободные весь период [startDate, endDate]: статус допускает бронирование
+    // и нет пересекающихся активных аренд. brand - начало марки без учета регистра (пусто - любая),
+    // maxPrice - предельная цена за день (0 - без ограничения)
+    QList<Car> findAvailableCars(const QDate& startDate, const QDate& endDate,
+                                 const QString& brand = QString(), double maxPrice = 0.0);
+    
     // Добавить автомобиль
     bool addCar(const Car& car);
     
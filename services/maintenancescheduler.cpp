@@ -0,0 +1,204 @@
+#include "maintenancescheduler.h"
+#include "overduefineengine.h"
+#include "../database/databasemanager.h"
+#include "../managers/reportmanager.h"
+#include "../utils/dateutils.h"
+#include <QSettings>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QDebug>
+
+MaintenanceConfig::MaintenanceConfig()
+    : tickMs(1000),
+      overdueFinesIntervalSec(15 * 60),
+      reportCacheIntervalSec(10 * 60),
+      analyzeIntervalSec(24 * 60 * 60),
+      vacuumIntervalSec(7 * 24 * 60 * 60)
+{
+}
+
+MaintenanceConfig MaintenanceConfig::load(const QString& settingsPath)
+{
+    MaintenanceConfig config;
+    if (!QFileInfo::exists(settingsPath)) {
+        return config;
+    }
+
+    QSettings settings(settingsPath, QSettings::IniFormat);
+    config.tickMs = qBound(100, settings.value("maintenance/tick_ms", config.tickMs).toInt(), 60000);
+    config.overdueFinesIntervalSec = qMax(0, settings.value("maintenance/overdue_fines_interval_sec",
+                                                            config.overdueFinesIntervalSec).toInt());
+    config.reportCacheIntervalSec = qMax(0, settings.value("maintenance/report_cache_interval_sec",
+                                                           config.reportCacheIntervalSec).toInt());
+    config.analyzeIntervalSec = qMax(0, settings.value("maintenance/analyze_interval_sec",
+                                                       config.analyzeIntervalSec).toInt());
+    config.vacuumIntervalSec = qMax(0, settings.value("maintenance/vacuum_interval_sec",
+                                                      config.vacuumIntervalSec).toInt());
+    return config;
+}
+
+MaintenanceWorker::MaintenanceWorker(int tickMs, QObject* parent)
+    : QObject(parent), m_tickMs(qMax(1, tickMs)), m_timer(nullptr)
+{
+}
+
+qint64 MaintenanceWorker::secondsToTicks(int seconds) const
+{
+    return (static_cast<qint64>(seconds) * 1000 + m_tickMs - 1) / m_tickMs;
+}
+
+void MaintenanceWorker::addJob(const QString& name, int intervalSec, int initialDelaySec,
+                               const std::function<bool()>& run)
+{
+    Job job;
+    job.stats.name = name;
+    job.stats.intervalSec = intervalSec;
+    job.stats.nextRunAt = QDateTime::currentDateTime().addSecs(initialDelaySec);
+    job.intervalTicks = qMax<qint64>(1, secondsToTicks(intervalSec));
+    job.run = run;
+    m_jobs.append(job);
+    m_wheel.schedule(m_jobs.size() - 1, secondsToTicks(initialDelaySec));
+}
+
+void MaintenanceWorker::start()
+{
+    // Таймер создается уже в потоке исполнителя, чтобы срабатывать в его цикле событий
+    if (!m_timer) {
+        m_timer = new QTimer(this);
+        connect(m_timer, &QTimer::timeout, this, &MaintenanceWorker::onTick);
+    }
+    m_timer->start(m_tickMs);
+}
+
+void MaintenanceWorker::onTick()
+{
+    for (int jobId : m_wheel.advance()) {
+        runJob(jobId);
+    }
+}
+
+void MaintenanceWorker::runJob(int jobId)
+{
+    Job& job = m_jobs[jobId];
+
+    QElapsedTimer timer;
+    timer.start();
+    bool ok = false;
+    {
+        ConnectionLease lease(DatabaseManager::getInstance().getConnectionPool());
+        ok = job.run();
+    }
+    qint64 elapsed = timer.elapsed();
+
+    MaintenanceJobStats& stats = job.stats;
+    stats.runCount++;
+    if (!ok) {
+        stats.failureCount++;
+    }
+    stats.lastSucceeded = ok;
+    stats.lastDurationMs = elapsed;
+    stats.maxDurationMs = qMax(stats.maxDurationMs, elapsed);
+    stats.totalDurationMs += elapsed;
+    stats.lastRunAt = QDateTime::currentDateTime();
+    stats.nextRunAt = stats.lastRunAt.addSecs(stats.intervalSec);
+
+    // Следующий запуск отсчитывается от завершения: долгая задача не накапливает пропущенные запуски
+    m_wheel.schedule(jobId, job.intervalTicks);
+
+    qDebug() << "Задача обслуживания" << stats.name << (ok ? "выполнена" : "завершилась с ошибкой")
+             << "за" << elapsed << "мс";
+    emit jobFinished(stats);
+}
+
+MaintenanceScheduler::MaintenanceScheduler(const MaintenanceConfig& config, QObject* parent)
+    : QObject(parent), m_config(config), m_worker(new MaintenanceWorker(config.tickMs))
+{
+    qRegisterMetaType<MaintenanceJobStats>();
+    m_thread.setObjectName("MaintenanceScheduler");
+    connect(m_worker, &MaintenanceWorker::jobFinished, this, &MaintenanceScheduler::onJobFinished);
+}
+
+MaintenanceScheduler::~MaintenanceScheduler()
+{
+    stop();
+    // Исполнитель без потока (планировщик не запускался) удаляем сами
+    if (m_worker) {
+        delete m_worker;
+    }
+}
+
+void MaintenanceScheduler::addJob(const QString& name, int intervalSec, int initialDelaySec,
+                                  const std::function<bool()>& run)
+{
+    if (!m_worker || m_thread.isRunning() || intervalSec <= 0) {
+        return;
+    }
+    m_worker->addJob(name, intervalSec, initialDelaySec, run);
+
+    MaintenanceJobStats stats;
+    stats.name = name;
+    stats.intervalSec = intervalSec;
+    stats.nextRunAt = QDateTime::currentDateTime().addSecs(initialDelaySec);
+    m_jobNames.append(name);
+    m_stats.insert(name, stats);
+}
+
+void MaintenanceScheduler::addDefaultJobs()
+{
+    // Штрафы и отчет - сразу после запуска, обслуживание файла - не раньше первого интервала
+    addJob("overdue_fines", m_config.overdueFinesIntervalSec, 0, []() {
+        return OverdueFineEngine::getInstance().sweep(DateUtils::currentDate()) >= 0;
+    });
+    addJob("report_cache", m_config.reportCacheIntervalSec, 0, []() {
+        // Отчет, который окно отчетов открывает по умолчанию: текущий месяц
+        QDate today = DateUtils::currentDate();
+        ReportManager reportManager;
+        reportManager.generatePeriodReport(QDate(today.year(), today.month(), 1), today,
+                                           ReportManager::DEFAULT_POPULAR_LIMIT);
+        return true;
+    });
+    addJob("analyze", m_config.analyzeIntervalSec, m_config.analyzeIntervalSec, []() {
+        return DatabaseManager::getInstance().analyzeDatabase();
+    });
+    addJob("vacuum", m_config.vacuumIntervalSec, m_config.vacuumIntervalSec, []() {
+        return DatabaseManager::getInstance().vacuumDatabase();
+    });
+}
+
+void MaintenanceScheduler::start()
+{
+    if (!m_worker || m_thread.isRunning()) {
+        return;
+    }
+    // После запуска исполнитель принадлежит потоку и удаляется вместе с его завершением
+    m_worker->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::started, m_worker, &MaintenanceWorker::start);
+    connect(&m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+    m_thread.start(QThread::LowPriority);
+}
+
+void MaintenanceScheduler::stop()
+{
+    if (!m_thread.isRunning()) {
+        return;
+    }
+    // Выполняющаяся задача завершается, новые не начинаются
+    m_thread.quit();
+    m_thread.wait();
+    m_worker = nullptr;
+}
+
+QList<MaintenanceJobStats> MaintenanceScheduler::getJobStats() const
+{
+    QList<MaintenanceJobStats> stats;
+    for (const QString& name : m_jobNames) {
+        stats.append(m_stats.value(name));
+    }
+    return stats;
+}
+
+void MaintenanceScheduler::onJobFinished(const MaintenanceJobStats& stats)
+{
+    m_stats.insert(stats.name, stats);
+    emit jobFinished(stats);
+}
@@ -0,0 +1,129 @@
+#ifndef MAINTENANCESCHEDULER_H
+#define MAINTENANCESCHEDULER_H
+
+#include <QObject>
+#include <QThread>
+#include <QTimer>
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QDateTime>
+#include <QMetaType>
+#include <functional>
+#include "../utils/timerwheel.h"
+
+// Интервалы фоновых задач обслуживания, секунды (0 - задача отключена).
+// Загружаются из секции [maintenance] файла database.ini
+struct MaintenanceConfig
+{
+    int tickMs;                     // шаг колеса таймеров
+    int overdueFinesIntervalSec;    // пересчет штрафов за просрочку
+    int reportCacheIntervalSec;     // предварительный расчет отчета за текущий месяц
+    int analyzeIntervalSec;         // ANALYZE
+    int vacuumIntervalSec;          // VACUUM
+
+    MaintenanceConfig();
+
+    static MaintenanceConfig load(const QString& settingsPath);
+};
+
+// Статистика выполнения задачи для мониторинга
+struct MaintenanceJobStats
+{
+    QString name;
+    int intervalSec;
+    int runCount;
+    int failureCount;
+    bool lastSucceeded;
+    qint64 lastDurationMs;
+    qint64 maxDurationMs;
+    qint64 totalDurationMs;
+    QDateTime lastRunAt;
+    QDateTime nextRunAt;
+
+    MaintenanceJobStats()
+        : intervalSec(0), runCount(0), failureCount(0), lastSucceeded(false),
+          lastDurationMs(0), maxDurationMs(0), totalDurationMs(0) {}
+
+    double getAverageDurationMs() const
+    {
+        return runCount > 0 ? static_cast<double>(totalDurationMs) / runCount : 0.0;
+    }
+};
+
+Q_DECLARE_METATYPE(MaintenanceJobStats)
+
+// Исполнитель задач: живет в потоке планировщика, по таймеру сдвигает колесо
+// и выполняет наступившие задачи под арендой соединения из пула
+class MaintenanceWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MaintenanceWorker(int tickMs, QObject* parent = nullptr);
+
+    // Задачи добавляются до запуска потока
+    void addJob(const QString& name, int intervalSec, int initialDelaySec, const std::function<bool()>& run);
+
+public slots:
+    void start();
+
+signals:
+    void jobFinished(const MaintenanceJobStats& stats);
+
+private slots:
+    void onTick();
+
+private:
+    struct Job {
+        MaintenanceJobStats stats;
+        qint64 intervalTicks;
+        std::function<bool()> run;
+    };
+
+    void runJob(int jobId);
+    qint64 secondsToTicks(int seconds) const;
+
+    int m_tickMs;
+    QTimer* m_timer;
+    TimerWheel m_wheel;
+    QList<Job> m_jobs;
+};
+
+// Планировщик фоновых задач обслуживания: пересчет штрафов, отчеты, ANALYZE/VACUUM.
+// Задачи выполняются в отдельном потоке и не блокируют интерфейс
+class MaintenanceScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MaintenanceScheduler(const MaintenanceConfig& config, QObject* parent = nullptr);
+    ~MaintenanceScheduler();
+
+    // Добавить задачу (до start). initialDelaySec = 0 - первый запуск на ближайшем шаге
+    void addJob(const QString& name, int intervalSec, int initialDelaySec, const std::function<bool()>& run);
+
+    // Стандартные задачи обслуживания с интервалами из конфигурации
+    void addDefaultJobs();
+
+    void start();
+    void stop();
+
+    // Статистика задач на момент последнего завершения каждой из них
+    QList<MaintenanceJobStats> getJobStats() const;
+
+signals:
+    void jobFinished(const MaintenanceJobStats& stats);
+
+private slots:
+    void onJobFinished(const MaintenanceJobStats& stats);
+
+private:
+    MaintenanceConfig m_config;
+    QThread m_thread;
+    MaintenanceWorker* m_worker;
+    QStringList m_jobNames;
+    QHash<QString, MaintenanceJobStats> m_stats;
+};
+
+#endif // MAINTENANCESCHEDULER_H
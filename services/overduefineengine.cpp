@@ -0,0 +1,274 @@
+#include "overduefineengine.h"
+#include "../database/databasemanager.h"
+#include <QMutexLocker>
+#include <QDebug>
+
+constexpr double OverdueFineEngine::FINE_MULTIPLIER;
+
+OverdueFineEngine& OverdueFineEngine::getInstance()
+{
+    static OverdueFineEngine instance;
+    return instance;
+}
+
+OverdueFineEngine::OverdueFineEngine()
+    : m_dbManager(&DatabaseManager::getInstance()), m_sweepMode(AutoSweep), m_loaded(false), m_revision(-1), m_sweepDay(0)
+{
+}
+
+void OverdueFineEngine::setSweepMode(SweepMode mode)
+{
+    QMutexLocker locker(&m_mutex);
+    m_sweepMode = mode;
+}
+
+void OverdueFineEngine::invalidate()
+{
+    QMutexLocker locker(&m_mutex);
+    m_loaded = false;
+}
+
+void OverdueFineEngine::rentalAdded(const Rental& rental)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_loaded || rental.getId() <= 0 || rental.isCompleted()) {
+        return;
+    }
+    DueEntry entry;
+    entry.endDay = rental.getEndDate().toJulianDay();
+    entry.rentalId = rental.getId();
+    entry.carId = rental.getCarId();
+    m_dueHeap.push(entry);
+    if (entry.endDay < m_sweepDay) {
+        // Аренда уже просрочена на день последнего прохода - сегодня нужен еще один
+        m_sweepDay = 0;
+    }
+    m_revision++;
+}
+
+void OverdueFineEngine::rentalCompleted(int rentalId)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_loaded) {
+        return;
+    }
+    if (!m_overdue.remove(rentalId)) {
+        m_completedInHeap.insert(rentalId);
+    }
+    m_revision++;
+}
+
+void OverdueFineEngine::fineAdded(const Fine& fine)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_loaded) {
+        return;
+    }
+    // ID нового штрафа нужен для его обновления - штраф перечитывается из БД
+    if (m_overdue.contains(fine.getRentalId()) && !m_overdue.value(fine.getRentalId()).hasFine) {
+        refreshFine(fine.getRentalId());
+    }
+    m_revision++;
+}
+
+void OverdueFineEngine::reload()
+{
+    m_dueHeap = std::priority_queue<DueEntry, std::vector<DueEntry>, std::greater<DueEntry> >();
+    m_completedInHeap.clear();
+    m_overdue.clear();
+
+    QList<Rental> activeRentals = m_dbManager->getActiveRentals();
+    std::vector<DueEntry> entries;
+    entries.reserve(activeRentals.size());
+    for (const Rental& rental : activeRentals) {
+        DueEntry entry;
+        entry.endDay = rental.getEndDate().toJulianDay();
+        entry.rentalId = rental.getId();
+        entry.carId = rental.getCarId();
+        entries.push_back(entry);
+    }
+    m_dueHeap = std::priority_queue<DueEntry, std::vector<DueEntry>, std::greater<DueEntry> >(
+        std::greater<DueEntry>(), std::move(entries));
+
+    m_loaded = true;
+}
+
+void OverdueFineEngine::promoteDue(const QDate& today)
+{
+    const qint64 todayDay = today.toJulianDay();
+    bool promoted = false;
+    while (!m_dueHeap.empty() && m_dueHeap.top().endDay < todayDay) {
+        const DueEntry& top = m_dueHeap.top();
+        if (m_completedInHeap.remove(top.rentalId)) {
+            m_dueHeap.pop();
+            continue;
+        }
+        OverdueEntry entry;
+        entry.carId = top.carId;
+        entry.endDate = QDate::fromJulianDay(top.endDay);
+        m_overdue.insert(top.rentalId, entry);
+        m_dueHeap.pop();
+        promoted = true;
+    }
+    if (promoted) {
+        refreshFines();
+    }
+}
+
+void OverdueFineEngine::refreshFines()
+{
+    QHash<int, Fine> fines = m_dbManager->getOverdueFinesOfActiveRentals();
+    for (auto it = m_overdue.begin(); it != m_overdue.end(); ++it) {
+        auto found = fines.constFind(it.key());
+        OverdueEntry& entry = it.value();
+        entry.hasFine = found != fines.constEnd();
+        entry.fine = entry.hasFine ? found.value() : Fine();
+    }
+}
+
+void OverdueFineEngine::refreshFine(int rentalId)
+{
+    OverdueEntry& entry = m_overdue[rentalId];
+    entry.hasFine = false;
+    entry.fine = Fine();
+    for (const Fine& fine : m_dbManager->getFinesByRentalId(rentalId)) {
+        if (fine.getDate() >= entry.endDate && (!entry.hasFine || fine.getId() < entry.fine.getId())) {
+            entry.fine = fine;
+            entry.hasFine = true;
+        }
+    }
+}
+
+int OverdueFineEngine::sweep(const QDate& today)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_dbManager || !today.isValid()) {
+        return 0;
+    }
+
+    const qint64 todayDay = today.toJulianDay();
+    const int revision = m_dbManager->getMaintenanceValue("rentals_revision");
+
+    if (!m_loaded) {
+        // Отметка предыдущего запуска: сегодня уже пересчитано и данные с тех пор не менялись
+        if (m_dbManager->getMaintenanceValue("overdue_sweep_day") == todayDay &&
+            m_dbManager->getMaintenanceValue("overdue_sweep_revision", -1) == revision) {
+            return 0;
+        }
+        reload();
+    } else if (revision != m_revision) {
+        // Данные изменены в обход уведомлений (другой процесс, импорт, правка штрафа или цены)
+        reload();
+    } else if (todayDay == m_sweepDay) {
+        return 0;
+    }
+
+    promoteDue(today);
+
+    // Большая доля просроченных аренд - пересчет двумя запросами вместо записи по каждому штрафу
+    const int activeCount = m_overdue.size() + static_cast<int>(m_dueHeap.size()) - m_completedInHeap.size();
+    const bool setBased = m_sweepMode == AutoSweep
+                          ? m_overdue.size() * SET_BASED_DIVISOR >= activeCount
+                          : m_sweepMode == SetBasedSweep;
+    if (setBased && !m_overdue.isEmpty()) {
+        return applySetBased(today);
+    }
+
+    QList<Fine> newFines;
+    QList<Fine> changedFines;
+    QHash<int, double> dailyPrices;
+    for (auto it = m_overdue.constBegin(); it != m_overdue.constEnd(); ++it) {
+        const OverdueEntry& entry = it.value();
+        int overdueDays = entry.endDate.daysTo(today);
+        if (overdueDays <= 0) {
+            continue;
+        }
+
+        auto price = dailyPrices.constFind(entry.carId);
+        if (price == dailyPrices.constEnd()) {
+            price = dailyPrices.insert(entry.carId, m_dbManager->getCarById(entry.carId).getDailyPrice());
+        }
+        double amount = price.value() * FINE_MULTIPLIER * overdueDays;
+        if (amount <= 0) {
+            continue;
+        }
+
+        QString reason = QString("Просрочка возврата на %1 день(ей)").arg(overdueDays);
+        if (!entry.hasFine) {
+            newFines.append(Fine(0, it.key(), amount, today, reason));
+        } else if (qAbs(entry.fine.getAmount() - amount) > 0.005) {
+            Fine fine = entry.fine;
+            fine.setAmount(amount);
+            fine.setDate(today);
+            fine.setReason(reason);
+            changedFines.append(fine);
+        }
+    }
+
+    // Все изменения и отметка прохода - одной транзакцией
+    if (!m_dbManager->beginTransaction()) {
+        m_loaded = false;
+        return -1;
+    }
+    bool ok = true;
+    for (const Fine& fine : newFines) {
+        ok = ok && m_dbManager->addFine(fine);
+    }
+    for (const Fine& fine : changedFines) {
+        ok = ok && m_dbManager->updateFine(fine);
+    }
+    if (!commitSweep(today, ok)) {
+        return -1;
+    }
+
+    for (const Fine& fine : changedFines) {
+        m_overdue[fine.getRentalId()].fine = fine;
+    }
+    if (!newFines.isEmpty()) {
+        // ID добавленных штрафов нужны для следующих обновлений
+        refreshFines();
+    }
+
+    int applied = newFines.size() + changedFines.size();
+    if (applied > 0) {
+        qDebug() << "Штрафы за просрочку: добавлено" << newFines.size() << ", обновлено" << changedFines.size();
+    }
+    return applied;
+}
+
+int OverdueFineEngine::applySetBased(const QDate& today)
+{
+    if (!m_dbManager->beginTransaction()) {
+        m_loaded = false;
+        return -1;
+    }
+    int applied = m_dbManager->applyOverdueFines(today, FINE_MULTIPLIER);
+    if (!commitSweep(today, applied >= 0)) {
+        return -1;
+    }
+
+    refreshFines();
+    if (applied > 0) {
+        qDebug() << "Штрафы за просрочку: добавлено и обновлено" << applied;
+    }
+    return applied;
+}
+
+bool OverdueFineEngine::commitSweep(const QDate& today, bool writesOk)
+{
+    // Собственные записи штрафов тоже увеличивают ревизию - фиксируем ее уже после них
+    const qint64 todayDay = today.toJulianDay();
+    const int revision = m_dbManager->getMaintenanceValue("rentals_revision");
+    bool ok = writesOk
+              && m_dbManager->setMaintenanceValue("overdue_sweep_day", static_cast<int>(todayDay))
+              && m_dbManager->setMaintenanceValue("overdue_sweep_revision", revision);
+    if (!ok || !m_dbManager->commitTransaction()) {
+        qDebug() << "Ошибка начисления штрафов за просрочку, изменения отменены";
+        m_dbManager->rollbackTransaction();
+        m_loaded = false;
+        return false;
+    }
+    m_revision = revision;
+    m_sweepDay = todayDay;
+    return true;
+}
@@ -2,6 +2,7 @@
 #define RENTALSEARCHSERVICE_H
 
 #include "../models/rental.h"
+#include "../database/rentalquerybuilder.h"
 #include <QList>
 #include <QDate>
 #include <QString>
@@ -19,13 +20,20 @@ public:
                                  const QDate& dateFrom = QDate(),
                                  const QDate& dateTo = QDate(),
                                  const QString& carBrand = QString());
+    
+    // Поиск по набору критериев: все условия объединяются в один запрос к БД
+    QList<Rental> searchRentals(const RentalSearchCriteria& criteria);
+    
+    // Постраничный поиск (от новых аренд к старым). Первая страница - с пустым курсором,
+    // следующие - с курсором RentalPage::next предыдущей
+    RentalPage searchRentalsPage(const RentalSearchCriteria& criteria,
+                                 const RentalPageCursor& cursor = RentalPageCursor(),
+                                 int pageSize = DEFAULT_PAGE_SIZE);
+    
+    static const int DEFAULT_PAGE_SIZE = 200;
 
 private:
     DatabaseManager* m_dbManager;
-    
-    // Найти пересечение списков аренд
-    QList<Rental> intersectRentalLists(const QList<QList<Rental>>& lists);
 };
 
 #endif // RENTALSEARCHSERVICE_H
-
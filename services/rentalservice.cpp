@@ -1,6 +1,7 @@
 #include "rentalservice.h"
 #include "../database/databasemanager.h"
 #include "../patterns/carstatusobserver.h"
+#include "overduefineengine.h"
 #include "../utils/dateutils.h"
 #include <QDebug>
 
@@ -22,23 +23,35 @@ bool RentalService::createRental(int carId, int userId, const QDate& startDate,
         return false;
     }
     
-    // Проверяем доступность автомобиля
+    // Быстрая проверка по индексу без блокировок: заведомо занятый автомобиль не ждет транзакцию
     if (!isCarAvailable(carId, startDate, endDate)) {
         qDebug() << "Автомобиль недоступен в указанный период!";
         return false;
     }
     
-    // Создаем аренду
-    Rental rental(0, carId, userId, startDate, endDate, totalCost, false);
-    
-    if (m_dbManager->addRental(rental)) {
-        // Обновляем статус автомобиля через Observer
-        updateCarStatusOnRentalStart(carId);
+    // Проверка, создание аренды и смена статуса автомобиля - одна транзакция
+    int rentalId = 0;
+    BookingResult result = m_dbManager->bookCar(carId, userId, startDate, endDate, totalCost, &rentalId);
+    switch (result) {
+    case BookingResult::Booked:
+        OverdueFineEngine::getInstance().rentalAdded(
+            Rental(rentalId, carId, userId, startDate, endDate, totalCost, false));
         qDebug() << "Аренда успешно создана!";
         return true;
+    case BookingResult::CarNotFound:
+        qDebug() << "Автомобиль не найден!";
+        return false;
+    case BookingResult::CarUnavailable:
+    case BookingResult::PeriodTaken:
+        qDebug() << "Автомобиль недоступен в указанный период!";
+        return false;
+    case BookingResult::Busy:
+        qDebug() << "База данных занята, бронирование не выполнено";
+        return false;
+    default:
+        qDebug() << "Ошибка создания аренды";
+        return false;
     }
-    
-    return false;
 }
 
 bool RentalService::completeRental(int rentalId, const QDate& actualReturnDate)
@@ -67,6 +80,7 @@ bool RentalService::completeRental(int rentalId, const QDate& actualReturnDate)
     rental.setCompleted(true);
     
     if (m_dbManager->updateRental(rental)) {
+        OverdueFineEngine::getInstance().rentalCompleted(rentalId);
         // Обновляем статус автомобиля через Observer
         updateCarStatusOnRentalComplete(rental.getCarId());
         qDebug() << "Аренда завершена!";
@@ -150,7 +164,11 @@ bool RentalService::applyFine(const Fine& fine)
         return false;
     }
     
-    return m_dbManager->addFine(fine);
+    if (!m_dbManager->addFine(fine)) {
+        return false;
+    }
+    OverdueFineEngine::getInstance().fineAdded(fine);
+    return true;
 }
 
 QList<Rental> RentalService::getActiveRentals() const
@@ -171,6 +189,15 @@ QList<Rental> RentalService::getUserRentals(int userId) const
     return m_dbManager->getRentalsByUserId(userId);
 }
 
+QList<RentalView> RentalService::getUserRentalViews(int userId) const
+{
+    if (!m_dbManager) {
+        return QList<RentalView>();
+    }
+    
+    return m_dbManager->getRentalViewsByUserId(userId);
+}
+
 Rental RentalService::getRentalById(int rentalId) const
 {
     if (!m_dbManager) {
@@ -205,27 +232,14 @@ bool RentalService::isCarAvailable(int carId, const QDate& startDate, const QDat
         return false;
     }
     
-    // Проверяем пересечение с существующими арендами
-    QList<Rental> activeRentals = m_dbManager->getActiveRentals();
-    for (const Rental& rental : activeRentals) {
-        if (rental.getCarId() == carId) {
-            // Проверяем пересечение дат
-            if (!(endDate < rental.getStartDate() || startDate > rental.getEndDate())) {
-                return false; // Есть пересечение
-            }
-        }
+    // Проверяем пересечение с существующими арендами по индексу периодов (без запроса к БД)
+    if (m_dbManager->getBookingIndex().hasOverlap(carId, startDate, endDate)) {
+        return false;
     }
     
     return true;
 }
 
-void RentalService::updateCarStatusOnRentalStart(int carId)
-{
-    if (m_statusSubject) {
-        m_statusSubject->notifyStatusChanged(carId, CarStatus::Rented);
-    }
-}
-
 void RentalService::updateCarStatusOnRentalComplete(int carId)
 {
     if (m_statusSubject) {
@@ -233,55 +247,14 @@ void RentalService::updateCarStatusOnRentalComplete(int carId)
     }
 }
 
-void RentalService::checkAndApplyOverdueFines()
+int RentalService::checkAndApplyOverdueFines()
 {
     if (!m_dbManager) {
-        return;
+        return -1;
     }
     
-    // Получаем все активные аренды
-    QList<Rental> activeRentals = m_dbManager->getActiveRentals();
-    QDate currentDate = DateUtils::currentDate(); // Текущая дата в системной временной зоне региона
-    
-    for (const Rental& rental : activeRentals) {
-        // Проверяем, просрочена ли аренда (текущая дата больше даты возврата)
-        if (currentDate > rental.getEndDate()) {
-            // Получаем существующие штрафы для этой аренды
-            QList<Fine> existingFines = m_dbManager->getFinesByRentalId(rental.getId());
-            
-            // Ищем штраф, начисленный сегодня или позже даты возврата
-            Fine existingFine;
-            bool fineExists = false;
-            for (const Fine& fine : existingFines) {
-                if (fine.getDate() >= rental.getEndDate()) {
-                    existingFine = fine;
-                    fineExists = true;
-                    break;
-                }
-            }
-            
-            // Рассчитываем актуальный штраф на текущую дату
-            Fine calculatedFine = calculateFine(rental.getId(), currentDate, 1.5);
-            
-            if (calculatedFine.getAmount() > 0) {
-                if (!fineExists) {
-                    // Штраф еще не начислен - начисляем новый
-                    applyFine(calculatedFine);
-                    qDebug() << "Автоматически начислен штраф за аренду #" << rental.getId() 
-                             << "в размере" << calculatedFine.getAmount() << "руб (просрочка на" 
-                             << rental.getEndDate().daysTo(currentDate) << "дней)";
-                } else if (existingFine.getAmount() != calculatedFine.getAmount()) {
-                    // Штраф уже есть, но сумма изменилась (прошло больше дней) - обновляем
-                    existingFine.setAmount(calculatedFine.getAmount());
-                    existingFine.setDate(currentDate);
-                    existingFine.setReason(QString("Просрочка возврата на %1 день(ей)").arg(
-                        rental.getEndDate().daysTo(currentDate)));
-                    m_dbManager->updateFine(existingFine);
-                    qDebug() << "Обновлен штраф за аренду #" << rental.getId() 
-                             << "до" << calculatedFine.getAmount() << "руб";
-                }
-            }
-        }
-    }
+    // Пересчитываются только аренды, срок которых истек; повторный вызов в тот же день без
+    // изменений данных не обращается к арендам и штрафам
+    return OverdueFineEngine::getInstance().sweep(DateUtils::currentDate());
 }
 
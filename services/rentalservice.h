@@ -2,6 +2,7 @@
 #define RENTALSERVICE_H
 
 #include "../models/rental.h"
+#include "../models/rentalview.h"
 #include "../models/car.h"
 #include "../models/fine.h"
 #include "../patterns/carstatusobserver.h"
@@ -44,6 +45,9 @@ public:
     // Получить аренды пользователя
     QList<Rental> getUserRentals(int userId) const;
     
+    // Получить аренды пользователя для отображения (автомобиль и сумма штрафов)
+    QList<RentalView> getUserRentalViews(int userId) const;
+    
     // Получить аренду по ID
     Rental getRentalById(int rentalId) const;
     
@@ -53,15 +57,18 @@ public:
     // Проверить доступность автомобиля в период
     bool isCarAvailable(int carId, const QDate& startDate, const QDate& endDate) const;
     
-    // Автоматическая проверка просроченных аренд и начисление штрафов
-    void checkAndApplyOverdueFines();
+    // Уведомления о смене статуса автомобилей (для пакетного завершения аренд через CarStatusBatch)
+    CarStatusSubject* getCarStatusSubject() const { return m_statusSubject; }
+    
+    // Автоматическая проверка просроченных аренд и начисление штрафов.
+    // Возвращает число начисленных и обновленных штрафов или -1 при ошибке записи
+    int checkAndApplyOverdueFines();
 
 private:
     DatabaseManager* m_dbManager;
     CarStatusSubject* m_statusSubject;
     CarStatusObserver* m_statusObserver;
     
-    void updateCarStatusOnRentalStart(int carId);
     void updateCarStatusOnRentalComplete(int carId);
 };
 
@@ -51,26 +51,32 @@ bool UserService::updateUser(const User& user)
     return m_dbManager->updateUser(user);
 }
 
-void UserService::completeAllUserRentals(int userId, const QDate& currentDate)
+bool UserService::completeAllUserRentals(int userId, const QDate& currentDate)
 {
     if (!m_rentalService) {
-        return;
+        return false;
     }
     
+    // Статусы освободившихся автомобилей записываются одним пакетом после завершения всех аренд
+    CarStatusBatch statusBatch(m_rentalService->getCarStatusSubject());
     QList<Rental> userRentals = m_rentalService->getUserRentals(userId);
+    bool ok = true;
     for (const Rental& rental : userRentals) {
         if (!rental.isCompleted()) {
             // Если есть просрочка - начисляем штраф на текущую дату
             if (currentDate > rental.getEndDate()) {
                 Fine fine = m_rentalService->calculateFine(rental.getId(), currentDate, 1.5);
-                if (fine.getAmount() > 0) {
-                    m_rentalService->applyFine(fine);
+                if (fine.getAmount() > 0 && !m_rentalService->applyFine(fine)) {
+                    ok = false;
                 }
             }
             // Завершаем аренду на текущую дату
-            m_rentalService->completeRental(rental.getId(), currentDate);
+            if (!m_rentalService->completeRental(rental.getId(), currentDate)) {
+                ok = false;
+            }
         }
     }
+    return statusBatch.commit() && ok;
 }
 
 bool UserService::deleteUser(int userId)
@@ -80,8 +86,12 @@ bool UserService::deleteUser(int userId)
     }
     
     // Завершаем все активные аренды пользователя с расчетом штрафов
+    // Если аренды не завершены или автомобили не освобождены, пользователь не удаляется
     QDate currentDate = DateUtils::currentDate();
-    completeAllUserRentals(userId, currentDate);
+    if (!completeAllUserRentals(userId, currentDate)) {
+        qDebug() << "Не удалось завершить аренды пользователя" << userId;
+        return false;
+    }
     
     // Удаляем пользователя
     return m_dbManager->deleteUser(userId);
@@ -40,8 +40,9 @@ private:
     DatabaseManager* m_dbManager;
     RentalService* m_rentalService;
     
-    // Завершить все активные аренды пользователя
-    void completeAllUserRentals(int userId, const QDate& currentDate);
+    // Завершить все активные аренды пользователя. false - часть записей не выполнена
+    // (в том числе пакетное освобождение автомобилей)
+    bool completeAllUserRentals(int userId, const QDate& currentDate);
 };
 
 #endif // USERSERVICE_H
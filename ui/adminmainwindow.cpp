@@ -2,10 +2,12 @@
 #include "cardialog.h"
 #include "reportswindow.h"
 #include "importexportdialog.h"
+#include "tableviewutils.h"
 #include "../services/carservice.h"
 #include "../services/userservice.h"
 #include "../services/rentalsearchservice.h"
 #include "../utils/dateutils.h"
+#include "../database/asyncdatabase.h"
 #include <QHeaderView>
 #include <QMessageBox>
 #include <QMenuBar>
@@ -15,21 +17,21 @@
 #include <QFormLayout>
 #include <QGroupBox>
 #include <QDateEdit>
+#include <QCheckBox>
 
 AdminMainWindow::AdminMainWindow(const User& user, QWidget *parent)
-    : QMainWindow(parent), m_user(user)
+    : QMainWindow(parent), m_user(user), m_rentalsTotalEstimate(-1), m_appendRentals(false)
 {
     m_dbManager = &DatabaseManager::getInstance();
     m_rentalService = new RentalService();
     m_carService = new CarService();
     m_userService = new UserService();
-    m_rentalSearchService = new RentalSearchService();
     m_reportManager = new ReportManager();
     
-    setupUI();
+    m_rentalsWatcher = new QFutureWatcher<RentalPage>(this);
+    connect(m_rentalsWatcher, &QFutureWatcher<RentalPage>::finished, this, &AdminMainWindow::onRentalsLoaded);
     
-    // Проверяем просроченные аренды при открытии окна
-    m_rentalService->checkAndApplyOverdueFines();
+    setupUI();
     
     loadCars();
     loadRentals();
@@ -42,10 +44,10 @@ AdminMainWindow::AdminMainWindow(const User& user, QWidget *parent)
 
 AdminMainWindow::~AdminMainWindow()
 {
+    AsyncDatabase::getInstance().cancel("admin/rentals");
     delete m_rentalService;
     delete m_carService;
     delete m_userService;
-    delete m_rentalSearchService;
     delete m_reportManager;
 }
 
@@ -117,13 +119,10 @@ void AdminMainWindow::setupCarsTab()
     layout->addLayout(buttonLayout);
     
     // Таблица автомобилей
-    m_carsTable = new QTableWidget();
-    m_carsTable->setColumnCount(5);
-    m_carsTable->setHorizontalHeaderLabels(QStringList() << "ID" << "Марка" << "Модель" << "Статус" << "Цена/день");
-    m_carsTable->setSelectionBehavior(QAbstractItemView::SelectRows);
-    m_carsTable->setSelectionMode(QAbstractItemView::SingleSelection);
-    m_carsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
-    m_carsTable->horizontalHeader()->setStretchLastSection(true);
+    m_carsModel = new CarTableModel(this);
+    m_carsTable = new QTableView();
+    m_carsTable->setModel(m_carsModel);
+    TableViewUtils::setupRecordTable(m_carsTable);
     
     layout->addWidget(m_carsTable);
     
@@ -140,36 +139,43 @@ void AdminMainWindow::setupRentalsTab()
     QFormLayout* searchLayout = new QFormLayout(searchGroup);
     
     m_searchClientEdit = new QLineEdit(this);
-    m_searchClientEdit->setPlaceholderText("Логин клиента (необязательно)");
+    m_searchClientEdit->setPlaceholderText("Логин или ФИО клиента (необязательно)");
     searchLayout->addRow("По клиенту:", m_searchClientEdit);
     
-    // Диапазон дат
+    // Диапазон дат. QDateEdit не принимает пустую дату, поэтому каждая граница включается
+    // своим флажком: поле без флажка недоступно, и onSearchRentals не передает границу
     QHBoxLayout* dateRangeLayout = new QHBoxLayout();
-    m_searchDateFromEdit = new QDateEdit(this);
+    m_searchDateFromCheck = new QCheckBox("С", this);
+    m_searchDateFromEdit = new QDateEdit(DateUtils::currentDate(), this);
     m_searchDateFromEdit->setCalendarPopup(true);
-    m_searchDateFromEdit->setDate(QDate());
-    m_searchDateFromEdit->setSpecialValueText("С даты");
     m_searchDateFromEdit->setDisplayFormat("dd.MM.yyyy");
+    m_searchDateFromEdit->setEnabled(false);
+    connect(m_searchDateFromCheck, &QCheckBox::toggled, m_searchDateFromEdit, &QDateEdit::setEnabled);
+    dateRangeLayout->addWidget(m_searchDateFromCheck);
     dateRangeLayout->addWidget(m_searchDateFromEdit);
     
-    QLabel* dateSeparator = new QLabel("—", this);
-    dateSeparator->setAlignment(Qt::AlignCenter);
-    dateRangeLayout->addWidget(dateSeparator);
-    
-    m_searchDateToEdit = new QDateEdit(this);
+    m_searchDateToCheck = new QCheckBox("по", this);
+    m_searchDateToEdit = new QDateEdit(DateUtils::currentDate(), this);
     m_searchDateToEdit->setCalendarPopup(true);
-    m_searchDateToEdit->setDate(QDate());
-    m_searchDateToEdit->setSpecialValueText("По дату");
     m_searchDateToEdit->setDisplayFormat("dd.MM.yyyy");
+    m_searchDateToEdit->setEnabled(false);
+    connect(m_searchDateToCheck, &QCheckBox::toggled, m_searchDateToEdit, &QDateEdit::setEnabled);
+    dateRangeLayout->addWidget(m_searchDateToCheck);
     dateRangeLayout->addWidget(m_searchDateToEdit);
     dateRangeLayout->addStretch();
     
     searchLayout->addRow("По дате:", dateRangeLayout);
     
     m_searchBrandEdit = new QLineEdit(this);
-    m_searchBrandEdit->setPlaceholderText("Марка автомобиля (необязательно)");
+    m_searchBrandEdit->setPlaceholderText("Марка или модель автомобиля (необязательно)");
     searchLayout->addRow("По марке:", m_searchBrandEdit);
     
+    m_searchStatusCombo = new QComboBox(this);
+    m_searchStatusCombo->addItem("Все", static_cast<int>(RentalStatusFilter::Any));
+    m_searchStatusCombo->addItem("Активные", static_cast<int>(RentalStatusFilter::Active));
+    m_searchStatusCombo->addItem("Завершенные", static_cast<int>(RentalStatusFilter::Completed));
+    searchLayout->addRow("По статусу:", m_searchStatusCombo);
+    
     QHBoxLayout* searchButtonLayout = new QHBoxLayout();
     m_searchRentalsButton = new QPushButton("Найти", this);
     m_clearSearchButton = new QPushButton("Очистить", this);
@@ -181,9 +187,10 @@ void AdminMainWindow::setupRentalsTab()
     connect(m_searchRentalsButton, &QPushButton::clicked, this, &AdminMainWindow::onSearchRentals);
     connect(m_clearSearchButton, &QPushButton::clicked, this, [this]() {
         m_searchClientEdit->clear();
-        m_searchDateFromEdit->setDate(QDate());
-        m_searchDateToEdit->setDate(QDate());
+        m_searchDateFromCheck->setChecked(false);
+        m_searchDateToCheck->setChecked(false);
         m_searchBrandEdit->clear();
+        m_searchStatusCombo->setCurrentIndex(0);
         loadRentals();
     });
     
@@ -201,16 +208,27 @@ void AdminMainWindow::setupRentalsTab()
     layout->addLayout(buttonLayout);
     
     // Таблица аренд
-    m_rentalsTable = new QTableWidget();
-    m_rentalsTable->setColumnCount(7);
-    m_rentalsTable->setHorizontalHeaderLabels(QStringList() << "ID" << "Клиент" << "Автомобиль" << "Начало" << "Окончание" << "Стоимость" << "Статус");
-    m_rentalsTable->setSelectionBehavior(QAbstractItemView::SelectRows);
-    m_rentalsTable->setSelectionMode(QAbstractItemView::SingleSelection);
-    m_rentalsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
-    m_rentalsTable->horizontalHeader()->setStretchLastSection(true);
+    m_rentalsModel = new RentalTableModel(QList<RentalTableModel::Column>()
+        << RentalTableModel::IdColumn << RentalTableModel::ClientColumn << RentalTableModel::CarColumn
+        << RentalTableModel::StartDateColumn << RentalTableModel::EndDateColumn
+        << RentalTableModel::CostColumn << RentalTableModel::StatusColumn, this);
+    m_rentalsTable = new QTableView();
+    m_rentalsTable->setModel(m_rentalsModel);
+    TableViewUtils::setupRecordTable(m_rentalsTable);
     
     layout->addWidget(m_rentalsTable);
     
+    // Аренды загружаются страницами от новых к старым
+    QHBoxLayout* pageLayout = new QHBoxLayout();
+    m_rentalsCountLabel = new QLabel(this);
+    m_loadMoreRentalsButton = new QPushButton("Загрузить еще", this);
+    m_loadMoreRentalsButton->setEnabled(false);
+    connect(m_loadMoreRentalsButton, &QPushButton::clicked, this, &AdminMainWindow::onLoadMoreRentals);
+    pageLayout->addWidget(m_rentalsCountLabel);
+    pageLayout->addStretch();
+    pageLayout->addWidget(m_loadMoreRentalsButton);
+    layout->addLayout(pageLayout);
+    
     m_tabWidget->addTab(m_rentalsTab, "Аренды");
 }
 
@@ -257,13 +275,10 @@ void AdminMainWindow::setupUsersTab()
     layout->addLayout(buttonLayout);
     
     // Таблица пользователей
-    m_usersTable = new QTableWidget();
-    m_usersTable->setColumnCount(3);
-    m_usersTable->setHorizontalHeaderLabels(QStringList() << "ID" << "Логин" << "Роль");
-    m_usersTable->setSelectionBehavior(QAbstractItemView::SelectRows);
-    m_usersTable->setSelectionMode(QAbstractItemView::SingleSelection);
-    m_usersTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
-    m_usersTable->horizontalHeader()->setStretchLastSection(true);
+    m_usersModel = new UserTableModel(this);
+    m_usersTable = new QTableView();
+    m_usersTable->setModel(m_usersModel);
+    TableViewUtils::setupRecordTable(m_usersTable);
     
     layout->addWidget(m_usersTable);
     
@@ -273,21 +288,13 @@ void AdminMainWindow::setupUsersTab()
 void AdminMainWindow::loadUsers()
 {
     if (!m_usersTable) return;
-    m_usersTable->clearContents();
     QList<User> users = m_userService->getAllUsers();
     updateUsersTable(users);
 }
 
 void AdminMainWindow::updateUsersTable(const QList<User>& users)
 {
-    m_usersTable->setRowCount(users.size());
-    
-    for (int i = 0; i < users.size(); ++i) {
-        const User& user = users[i];
-        m_usersTable->setItem(i, 0, new QTableWidgetItem(QString::number(user.getId())));
-        m_usersTable->setItem(i, 1, new QTableWidgetItem(user.getUsername()));
-        m_usersTable->setItem(i, 2, new QTableWidgetItem(user.getRoleString()));
-    }
+    m_usersModel->setUsers(users);
 }
 
 void AdminMainWindow::loadCars()
@@ -298,9 +305,48 @@ void AdminMainWindow::loadCars()
 
 void AdminMainWindow::loadRentals()
 {
-    // Используем сервис поиска без параметров для получения всех аренд
-    QList<Rental> rentals = m_rentalSearchService->searchRentals();
-    updateRentalsTable(rentals);
+    // Поиск без параметров - все аренды, первая страница
+    m_rentalCriteria = RentalSearchCriteria();
+    requestRentalsPage(false);
+}
+
+void AdminMainWindow::requestRentalsPage(bool append)
+{
+    m_appendRentals = append;
+    RentalPageCursor cursor = append ? m_rentalCursor : RentalPageCursor();
+    m_loadMoreRentalsButton->setEnabled(false);
+    m_rentalsWatcher->setFuture(AsyncDatabase::getInstance().searchRentalsPage("admin/rentals", m_rentalCriteria, cursor,
+                                                                               RentalSearchService::DEFAULT_PAGE_SIZE));
+}
+
+void AdminMainWindow::onLoadMoreRentals()
+{
+    if (m_rentalCursor.isValid()) {
+        requestRentalsPage(true);
+    }
+}
+
+void AdminMainWindow::onRentalsLoaded()
+{
+    // Отмененный (вытесненный более новым) запрос не отображаем
+    if (m_rentalsWatcher->isCanceled()) {
+        return;
+    }
+    
+    RentalPage page = m_rentalsWatcher->result();
+    updateRentalsTable(page.rentals, m_appendRentals);
+    m_rentalCursor = page.next;
+    if (page.totalEstimate >= 0) {
+        m_rentalsTotalEstimate = page.totalEstimate;
+    }
+    m_loadMoreRentalsButton->setEnabled(page.hasMore);
+    
+    int shown = m_rentalsModel->rowCount();
+    if (page.hasMore && m_rentalsTotalEstimate > shown) {
+        m_rentalsCountLabel->setText(QString("Показано %1 из ~%2").arg(shown).arg(m_rentalsTotalEstimate));
+    } else {
+        m_rentalsCountLabel->setText(QString("Показано %1").arg(shown));
+    }
 }
 
 int AdminMainWindow::getSelectedUserId()
@@ -308,46 +354,22 @@ int AdminMainWindow::getSelectedUserId()
     if (!m_usersTable) {
         return 0;
     }
-    int row = m_usersTable->currentRow();
-    if (row >= 0 && row < m_usersTable->rowCount()) {
-        QTableWidgetItem* item = m_usersTable->item(row, 0);
-        if (item) {
-            return item->text().toInt();
-        }
-    }
-    return 0;
+    QModelIndex current = m_usersTable->currentIndex();
+    return current.isValid() ? m_usersModel->getUserId(current.row()) : 0;
 }
 
 void AdminMainWindow::updateCarsTable(const QList<Car>& cars)
 {
-    m_carsTable->setRowCount(cars.size());
-    
-    for (int i = 0; i < cars.size(); ++i) {
-        const Car& car = cars[i];
-        m_carsTable->setItem(i, 0, new QTableWidgetItem(QString::number(car.getId())));
-        m_carsTable->setItem(i, 1, new QTableWidgetItem(car.getBrand()));
-        m_carsTable->setItem(i, 2, new QTableWidgetItem(car.getModel()));
-        m_carsTable->setItem(i, 3, new QTableWidgetItem(car.getStatusString()));
-        m_carsTable->setItem(i, 4, new QTableWidgetItem(QString::number(car.getDailyPrice(), 'f', 2) + " руб"));
-    }
+    m_carsModel->setCars(cars);
 }
 
-void AdminMainWindow::updateRentalsTable(const QList<Rental>& rentals)
+void AdminMainWindow::updateRentalsTable(const QList<RentalView>& rentals, bool append)
 {
-    m_rentalsTable->setRowCount(rentals.size());
-    
-    for (int i = 0; i < rentals.size(); ++i) {
-        const Rental& rental = rentals[i];
-        Car car = m_carService->getCarById(rental.getCarId());
-        User user = m_userService->getUserById(rental.getUserId());
-        
-        m_rentalsTable->setItem(i, 0, new QTableWidgetItem(QString::number(rental.getId())));
-        m_rentalsTable->setItem(i, 1, new QTableWidgetItem(user.getUsername()));
-        m_rentalsTable->setItem(i, 2, new QTableWidgetItem(car.getFullName()));
-        m_rentalsTable->setItem(i, 3, new QTableWidgetItem(rental.getStartDate().toString("dd.MM.yyyy")));
-        m_rentalsTable->setItem(i, 4, new QTableWidgetItem(rental.getEndDate().toString("dd.MM.yyyy")));
-        m_rentalsTable->setItem(i, 5, new QTableWidgetItem(QString::number(rental.getTotalCost(), 'f', 2) + " руб"));
-        m_rentalsTable->setItem(i, 6, new QTableWidgetItem(rental.isCompleted() ? "Завершена" : "Активна"));
+    // При дозагрузке страница добавляется после уже показанных строк
+    if (append) {
+        m_rentalsModel->appendRentals(rentals);
+    } else {
+        m_rentalsModel->setRentals(rentals);
     }
 }
 
@@ -429,14 +451,17 @@ void AdminMainWindow::onDeleteCar()
 
 void AdminMainWindow::onSearchRentals()
 {
-    QString clientName = m_searchClientEdit->text().trimmed();
-    QDate dateFrom = m_searchDateFromEdit->date();
-    QDate dateTo = m_searchDateToEdit->date();
-    QString brand = m_searchBrandEdit->text().trimmed();
-    
-    // Используем сервис поиска с диапазоном дат
-    QList<Rental> rentals = m_rentalSearchService->searchRentals(clientName, dateFrom, dateTo, brand);
-    updateRentalsTable(rentals);
+    RentalSearchCriteria criteria;
+    criteria.clientText = m_searchClientEdit->text().trimmed();
+    criteria.carText = m_searchBrandEdit->text().trimmed();
+    // Граница без флажка не задана - в критериях остается недействительная дата
+    criteria.dateFrom = m_searchDateFromCheck->isChecked() ? m_searchDateFromEdit->date() : QDate();
+    criteria.dateTo = m_searchDateToCheck->isChecked() ? m_searchDateToEdit->date() : QDate();
+    criteria.status = static_cast<RentalStatusFilter>(m_searchStatusCombo->currentData().toInt());
+    
+    // Все критерии объединяются в один запрос к БД; результаты выводятся постранично
+    m_rentalCriteria = criteria;
+    requestRentalsPage(false);
 }
 
 void AdminMainWindow::onCompleteRental()
@@ -537,26 +562,14 @@ void AdminMainWindow::onLogout()
 
 int AdminMainWindow::getSelectedCarId()
 {
-    int row = m_carsTable->currentRow();
-    if (row >= 0 && row < m_carsTable->rowCount()) {
-        QTableWidgetItem* item = m_carsTable->item(row, 0);
-        if (item) {
-            return item->text().toInt();
-        }
-    }
-    return 0;
+    QModelIndex current = m_carsTable->currentIndex();
+    return current.isValid() ? m_carsModel->getCarId(current.row()) : 0;
 }
 
 int AdminMainWindow::getSelectedRentalId()
 {
-    int row = m_rentalsTable->currentRow();
-    if (row >= 0 && row < m_rentalsTable->rowCount()) {
-        QTableWidgetItem* item = m_rentalsTable->item(row, 0);
-        if (item) {
-            return item->text().toInt();
-        }
-    }
-    return 0;
+    QModelIndex current = m_rentalsTable->currentIndex();
+    return current.isValid() ? m_rentalsModel->getRentalId(current.row()) : 0;
 }
 
 void AdminMainWindow::updateDateLabel()
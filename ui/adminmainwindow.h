@@ -3,7 +3,8 @@
 
 #include <QMainWindow>
 #include <QTabWidget>
-#include <QTableWidget>
+#include <QTableView>
+#include <QHeaderView>
 #include <QPushButton>
 #include <QLineEdit>
 #include <QLabel>
@@ -12,10 +13,15 @@
 #include <QGroupBox>
 #include <QComboBox>
 #include <QDateEdit>
+#include <QCheckBox>
+#include <QFutureWatcher>
 #include "../models/user.h"
 #include "../models/car.h"
 #include "../models/rental.h"
 #include "../database/databasemanager.h"
+#include "cartablemodel.h"
+#include "rentaltablemodel.h"
+#include "usertablemodel.h"
 #include "../services/rentalservice.h"
 #include "../services/carservice.h"
 #include "../services/userservice.h"
@@ -41,6 +47,8 @@ private slots:
     void onImportExport();
     void onLogout();
     void onSearchRentals();
+    void onRentalsLoaded();
+    void onLoadMoreRentals();
 
 private:
     User m_user;
@@ -48,7 +56,6 @@ private:
     RentalService* m_rentalService;
     CarService* m_carService;
     UserService* m_userService;
-    RentalSearchService* m_rentalSearchService;
     ReportManager* m_reportManager;
     
     // UI элементы
@@ -59,19 +66,34 @@ private:
     QPushButton* m_addCarButton;
     QPushButton* m_editCarButton;
     QPushButton* m_deleteCarButton;
-    QTableWidget* m_carsTable;
+    QTableView* m_carsTable;
+    CarTableModel* m_carsModel;
     
     // Вкладка "Аренды"
     QWidget* m_rentalsTab;
     QPushButton* m_completeRentalButton;
-    QTableWidget* m_rentalsTable;
+    QTableView* m_rentalsTable;
+    RentalTableModel* m_rentalsModel;
     QLineEdit* m_searchClientEdit;
+    QCheckBox* m_searchDateFromCheck;
     QDateEdit* m_searchDateFromEdit;
+    QCheckBox* m_searchDateToCheck;
     QDateEdit* m_searchDateToEdit;
     QLineEdit* m_searchBrandEdit;
+    QComboBox* m_searchStatusCombo;
     QPushButton* m_searchRentalsButton;
     QPushButton* m_clearSearchButton;
     
+    // Загрузка и поиск аренд выполняются в фоне; новый запрос вытесняет незавершенный
+    QPushButton* m_loadMoreRentalsButton;
+    QLabel* m_rentalsCountLabel;
+    // Поиск аренд постранично: текущие критерии, курсор следующей страницы и режим дозагрузки
+    QFutureWatcher<RentalPage>* m_rentalsWatcher;
+    RentalSearchCriteria m_rentalCriteria;
+    RentalPageCursor m_rentalCursor;
+    int m_rentalsTotalEstimate;
+    bool m_appendRentals;
+    
     // Вкладка "Статистика"
     QWidget* m_statsTab;
     QLabel* m_totalCarsLabel;
@@ -81,7 +103,8 @@ private:
     
     // Вкладка "Пользователи"
     QWidget* m_usersTab;
-    QTableWidget* m_usersTable;
+    QTableView* m_usersTable;
+    UserTableModel* m_usersModel;
     QPushButton* m_deleteUserButton;
     
     // Статус-бар
@@ -95,9 +118,10 @@ private:
     void setupUsersTab();
     void loadCars();
     void loadRentals();
+    void requestRentalsPage(bool append);
     void loadUsers();
     void updateCarsTable(const QList<Car>& cars);
-    void updateRentalsTable(const QList<Rental>& rentals);
+    void updateRentalsTable(const QList<RentalView>& rentals, bool append = false);
     void updateUsersTable(const QList<User>& users);
     void updateStatistics();
     int getSelectedCarId();
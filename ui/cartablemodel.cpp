@@ -0,0 +1,88 @@
+#include "cartablemodel.h"
+
+CarTableModel::CarTableModel(QObject* parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+int CarTableModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_ids.size();
+}
+
+int CarTableModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant CarTableModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_ids.size() || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    
+    int row = index.row();
+    switch (index.column()) {
+    case IdColumn:
+        return m_ids[row];
+    case BrandColumn:
+        return m_brands[row];
+    case ModelColumn:
+        return m_models[row];
+    case StatusColumn:
+        return Car::statusToString(m_statuses[row]);
+    case PriceColumn:
+        return QString::number(m_prices[row], 'f', 2) + " руб";
+    default:
+        return QVariant();
+    }
+}
+
+QVariant CarTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    
+    switch (section) {
+    case IdColumn: return "ID";
+    case BrandColumn: return "Марка";
+    case ModelColumn: return "Модель";
+    case StatusColumn: return "Статус";
+    case PriceColumn: return "Цена/день";
+    default: return QVariant();
+    }
+}
+
+void CarTableModel::setCars(const QList<Car>& cars)
+{
+    beginResetModel();
+    m_ids.clear();
+    m_brands.clear();
+    m_models.clear();
+    m_statuses.clear();
+    m_prices.clear();
+    m_ids.reserve(cars.size());
+    m_brands.reserve(cars.size());
+    m_models.reserve(cars.size());
+    m_statuses.reserve(cars.size());
+    m_prices.reserve(cars.size());
+    for (const Car& car : cars) {
+        appendRow(car);
+    }
+    endResetModel();
+}
+
+int CarTableModel::getCarId(int row) const
+{
+    return (row >= 0 && row < m_ids.size()) ? m_ids[row] : 0;
+}
+
+void CarTableModel::appendRow(const Car& car)
+{
+    m_ids.append(car.getId());
+    m_brands.append(car.getBrand());
+    m_models.append(car.getModel());
+    m_statuses.append(car.getStatus());
+    m_prices.append(car.getDailyPrice());
+}
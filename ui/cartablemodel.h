@@ -0,0 +1,49 @@
+#ifndef CARTABLEMODEL_H
+#define CARTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QVector>
+#include <QList>
+#include "../models/car.h"
+
+// Модель таблицы автомобилей для QTableView.
+// Данные хранятся по колонкам (отдельный вектор на каждое поле), строки для
+// отображения формируются в data() только для видимых ячеек
+class CarTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        IdColumn,
+        BrandColumn,
+        ModelColumn,
+        StatusColumn,
+        PriceColumn,
+        ColumnCount
+    };
+    
+    explicit CarTableModel(QObject* parent = nullptr);
+    
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    
+    // Заменить все строки
+    void setCars(const QList<Car>& cars);
+    
+    // ID автомобиля в строке, 0 - строка вне диапазона
+    int getCarId(int row) const;
+
+private:
+    void appendRow(const Car& car);
+    
+    QVector<int> m_ids;
+    QVector<QString> m_brands;
+    QVector<QString> m_models;
+    QVector<CarStatus> m_statuses;
+    QVector<double> m_prices;
+};
+
+#endif // CARTABLEMODEL_H
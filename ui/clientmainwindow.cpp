@@ -1,5 +1,6 @@
 #include "clientmainwindow.h"
 #include "rentaldialog.h"
+#include "tableviewutils.h"
 #include "../models/fine.h"
 #include "../services/carservice.h"
 #include "../utils/dateutils.h"
@@ -20,9 +21,6 @@ ClientMainWindow::ClientMainWindow(const User& user, QWidget *parent)
     
     setupUI();
     
-    // Проверяем просроченные аренды при открытии окна
-    m_rentalService->checkAndApplyOverdueFines();
-    
     loadAvailableCars();
     loadUserRentals();
     
@@ -78,8 +76,31 @@ void ClientMainWindow::setupCarsTab()
     m_searchEdit->setPlaceholderText("Поиск по марке...");
     m_searchButton = new QPushButton("Найти");
     
+    // Период аренды: показываются автомобили, свободные на все эти даты
+    m_periodFromEdit = new QDateEdit(DateUtils::currentDate());
+    m_periodFromEdit->setCalendarPopup(true);
+    m_periodFromEdit->setMinimumDate(DateUtils::currentDate());
+    m_periodFromEdit->setDisplayFormat("dd.MM.yyyy");
+    m_periodToEdit = new QDateEdit(DateUtils::currentDate().addDays(1));
+    m_periodToEdit->setCalendarPopup(true);
+    m_periodToEdit->setMinimumDate(DateUtils::currentDate());
+    m_periodToEdit->setDisplayFormat("dd.MM.yyyy");
+    
+    m_maxPriceSpin = new QDoubleSpinBox();
+    m_maxPriceSpin->setRange(0.0, 1000000.0);
+    m_maxPriceSpin->setDecimals(0);
+    m_maxPriceSpin->setSingleStep(500.0);
+    m_maxPriceSpin->setSpecialValueText("Любая");
+    m_maxPriceSpin->setSuffix(" руб");
+    
     searchLayout->addWidget(new QLabel("Поиск:"));
     searchLayout->addWidget(m_searchEdit);
+    searchLayout->addWidget(new QLabel("с"));
+    searchLayout->addWidget(m_periodFromEdit);
+    searchLayout->addWidget(new QLabel("по"));
+    searchLayout->addWidget(m_periodToEdit);
+    searchLayout->addWidget(new QLabel("Цена/день до:"));
+    searchLayout->addWidget(m_maxPriceSpin);
     searchLayout->addWidget(m_searchButton);
     searchLayout->addStretch();
     
@@ -88,13 +109,10 @@ void ClientMainWindow::setupCarsTab()
     layout->addLayout(searchLayout);
     
     // Таблица автомобилей
-    m_carsTable = new QTableWidget();
-    m_carsTable->setColumnCount(5);
-    m_carsTable->setHorizontalHeaderLabels(QStringList() << "ID" << "Марка" << "Модель" << "Статус" << "Цена/день");
-    m_carsTable->setSelectionBehavior(QAbstractItemView::SelectRows);
-    m_carsTable->setSelectionMode(QAbstractItemView::SingleSelection);
-    m_carsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
-    m_carsTable->horizontalHeader()->setStretchLastSection(true);
+    m_carsModel = new CarTableModel(this);
+    m_carsTable = new QTableView();
+    m_carsTable->setModel(m_carsModel);
+    TableViewUtils::setupRecordTable(m_carsTable);
     
     layout->addWidget(m_carsTable);
     
@@ -122,13 +140,13 @@ void ClientMainWindow::setupRentalsTab()
     layout->addLayout(buttonLayout);
     
     // Таблица аренд
-    m_rentalsTable = new QTableWidget();
-    m_rentalsTable->setColumnCount(7);
-    m_rentalsTable->setHorizontalHeaderLabels(QStringList() << "ID" << "Автомобиль" << "Начало" << "Окончание" << "Стоимость" << "Статус" << "Просрочка");
-    m_rentalsTable->setSelectionBehavior(QAbstractItemView::SelectRows);
-    m_rentalsTable->setSelectionMode(QAbstractItemView::SingleSelection);
-    m_rentalsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
-    m_rentalsTable->horizontalHeader()->setStretchLastSection(true);
+    m_rentalsModel = new RentalTableModel(QList<RentalTableModel::Column>()
+        << RentalTableModel::IdColumn << RentalTableModel::CarColumn
+        << RentalTableModel::StartDateColumn << RentalTableModel::EndDateColumn << RentalTableModel::CostColumn
+        << RentalTableModel::StatusColumn << RentalTableModel::OverdueColumn, this);
+    m_rentalsTable = new QTableView();
+    m_rentalsTable->setModel(m_rentalsModel);
+    TableViewUtils::setupRecordTable(m_rentalsTable);
     
     layout->addWidget(m_rentalsTable);
     
@@ -137,90 +155,40 @@ void ClientMainWindow::setupRentalsTab()
 
 void ClientMainWindow::loadAvailableCars()
 {
-    QList<Car> cars = m_carService->getAvailableCars();
-    updateCarsTable(cars);
+    // Список всегда соответствует выбранному периоду и фильтрам
+    onSearchCars();
 }
 
 void ClientMainWindow::loadUserRentals()
 {
-    QList<Rental> rentals = m_rentalService->getUserRentals(m_user.getId());
+    QList<RentalView> rentals = m_rentalService->getUserRentalViews(m_user.getId());
     updateRentalsTable(rentals);
 }
 
 void ClientMainWindow::updateCarsTable(const QList<Car>& cars)
 {
-    m_carsTable->setRowCount(cars.size());
-    
-    for (int i = 0; i < cars.size(); ++i) {
-        const Car& car = cars[i];
-        m_carsTable->setItem(i, 0, new QTableWidgetItem(QString::number(car.getId())));
-        m_carsTable->setItem(i, 1, new QTableWidgetItem(car.getBrand()));
-        m_carsTable->setItem(i, 2, new QTableWidgetItem(car.getModel()));
-        m_carsTable->setItem(i, 3, new QTableWidgetItem(car.getStatusString()));
-        m_carsTable->setItem(i, 4, new QTableWidgetItem(QString::number(car.getDailyPrice(), 'f', 2) + " руб"));
-    }
+    m_carsModel->setCars(cars);
 }
 
-void ClientMainWindow::updateRentalsTable(const QList<Rental>& rentals)
+void ClientMainWindow::updateRentalsTable(const QList<RentalView>& rentals)
 {
-    m_rentalsTable->setRowCount(rentals.size());
-    
-    for (int i = 0; i < rentals.size(); ++i) {
-        const Rental& rental = rentals[i];
-        Car car = m_carService->getCarById(rental.getCarId());
-        
-        m_rentalsTable->setItem(i, 0, new QTableWidgetItem(QString::number(rental.getId())));
-        m_rentalsTable->setItem(i, 1, new QTableWidgetItem(car.getFullName()));
-        m_rentalsTable->setItem(i, 2, new QTableWidgetItem(rental.getStartDate().toString("dd.MM.yyyy")));
-        m_rentalsTable->setItem(i, 3, new QTableWidgetItem(rental.getEndDate().toString("dd.MM.yyyy")));
-        m_rentalsTable->setItem(i, 4, new QTableWidgetItem(QString::number(rental.getTotalCost(), 'f', 2) + " руб"));
-        
-        QString status = rental.isCompleted() ? "Завершена" : "Активна";
-        m_rentalsTable->setItem(i, 5, new QTableWidgetItem(status));
-        
-        // Информация о просрочке
-        QString overdueInfo = "";
-        if (!rental.isCompleted()) {
-            int overdueDays = rental.getDaysOverdue();
-            if (overdueDays > 0) {
-                overdueInfo = QString("Просрочка: %1 дн.").arg(overdueDays);
-                // Получаем сумму штрафа
-                QList<Fine> fines = m_rentalService->getFinesByRentalId(rental.getId());
-                double totalFine = 0.0;
-                for (const Fine& fine : fines) {
-                    totalFine += fine.getAmount();
-                }
-                if (totalFine > 0) {
-                    overdueInfo += QString(" (штраф: %1 руб)").arg(totalFine, 0, 'f', 2);
-                }
-            } else {
-                overdueInfo = "В срок";
-            }
-        } else {
-            overdueInfo = "-";
-        }
-        m_rentalsTable->setItem(i, 6, new QTableWidgetItem(overdueInfo));
-    }
+    // Текст ячеек (даты, суммы, просрочка) формируется моделью при отображении
+    m_rentalsModel->setRentals(rentals);
 }
 
 void ClientMainWindow::onSearchCars()
 {
-    QString searchText = m_searchEdit->text().trimmed();
-    
-    if (searchText.isEmpty()) {
-        loadAvailableCars();
-        return;
+    QDate startDate = m_periodFromEdit->date();
+    QDate endDate = m_periodToEdit->date();
+    if (endDate < startDate) {
+        endDate = startDate;
+        m_periodToEdit->setDate(endDate);
     }
     
-    QList<Car> cars = m_carService->getCarsByBrand(searchText);
-    // Фильтруем только доступные
-    QList<Car> availableCars;
-    for (const Car& car : cars) {
-        if (car.getStatus() == CarStatus::Available) {
-            availableCars.append(car);
-        }
-    }
-    updateCarsTable(availableCars);
+    QList<Car> cars = m_carService->findAvailableCars(startDate, endDate,
+                                                      m_searchEdit->text().trimmed(),
+                                                      m_maxPriceSpin->value());
+    updateCarsTable(cars);
 }
 
 void ClientMainWindow::onCompleteRental()
@@ -322,7 +290,9 @@ void ClientMainWindow::onRentCar()
         return;
     }
     
-    RentalDialog dialog(car, m_user.getId(), m_pricingCalculator, this);
+    // Диалог открывается с периодом, для которого автомобиль найден свободным
+    RentalDialog dialog(car, m_user.getId(), m_pricingCalculator, this,
+                        m_periodFromEdit->date(), m_periodToEdit->date());
     if (dialog.exec() == QDialog::Accepted) {
         loadAvailableCars();
         loadUserRentals();
@@ -337,26 +307,14 @@ void ClientMainWindow::onLogout()
 
 int ClientMainWindow::getSelectedCarId()
 {
-    int row = m_carsTable->currentRow();
-    if (row >= 0 && row < m_carsTable->rowCount()) {
-        QTableWidgetItem* item = m_carsTable->item(row, 0);
-        if (item) {
-            return item->text().toInt();
-        }
-    }
-    return 0;
+    QModelIndex current = m_carsTable->currentIndex();
+    return current.isValid() ? m_carsModel->getCarId(current.row()) : 0;
 }
 
 int ClientMainWindow::getSelectedRentalId()
 {
-    int row = m_rentalsTable->currentRow();
-    if (row >= 0 && row < m_rentalsTable->rowCount()) {
-        QTableWidgetItem* item = m_rentalsTable->item(row, 0);
-        if (item) {
-            return item->text().toInt();
-        }
-    }
-    return 0;
+    QModelIndex current = m_rentalsTable->currentIndex();
+    return current.isValid() ? m_rentalsModel->getRentalId(current.row()) : 0;
 }
 
 void ClientMainWindow::updateDateLabel()
@@ -3,20 +3,26 @@
 
 #include <QMainWindow>
 #include <QTabWidget>
-#include <QTableWidget>
+#include <QTableView>
+#include <QHeaderView>
 #include <QPushButton>
 #include <QLineEdit>
 #include <QLabel>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QGroupBox>
+#include <QDateEdit>
+#include <QDoubleSpinBox>
 #include "../models/user.h"
 #include "../models/car.h"
 #include "../models/rental.h"
+#include "../models/rentalview.h"
 #include "../services/rentalservice.h"
 #include "../services/pricingcalculator.h"
 #include "../services/carservice.h"
 #include "../database/databasemanager.h"
+#include "cartablemodel.h"
+#include "rentaltablemodel.h"
 
 class ClientMainWindow : public QMainWindow
 {
@@ -46,12 +52,17 @@ private:
     QWidget* m_carsTab;
     QLineEdit* m_searchEdit;
     QPushButton* m_searchButton;
-    QTableWidget* m_carsTable;
+    QDateEdit* m_periodFromEdit;
+    QDateEdit* m_periodToEdit;
+    QDoubleSpinBox* m_maxPriceSpin;
+    QTableView* m_carsTable;
+    CarTableModel* m_carsModel;
     
     // Вкладка "Мои аренды"
     QWidget* m_rentalsTab;
     QPushButton* m_completeRentalButton;
-    QTableWidget* m_rentalsTable;
+    QTableView* m_rentalsTable;
+    RentalTableModel* m_rentalsModel;
     
     // Статус-бар
     QLabel* m_dateLabel;
@@ -63,7 +74,7 @@ private:
     void loadAvailableCars();
     void loadUserRentals();
     void updateCarsTable(const QList<Car>& cars);
-    void updateRentalsTable(const QList<Rental>& rentals);
+    void updateRentalsTable(const QList<RentalView>& rentals);
     int getSelectedCarId();
     int getSelectedRentalId();
 };
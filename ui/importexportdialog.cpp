@@ -1,5 +1,6 @@
 #include "importexportdialog.h"
 #include "../utils/dateutils.h"
+#include "../database/asyncdatabase.h"
 #include <QDateEdit>
 #include <QFormLayout>
 
@@ -8,6 +9,8 @@ ImportExportDialog::ImportExportDialog(DatabaseManager* dbManager, QWidget *pare
 {
     m_exporter = new DataExporter(dbManager);
     m_importer = new DataImporter(dbManager);
+    m_importWatcher = new QFutureWatcher<ImportResult>(this);
+    connect(m_importWatcher, &QFutureWatcher<ImportResult>::finished, this, &ImportExportDialog::onImportFinished);
     setupUI();
     setWindowTitle("Импорт/Экспорт данных");
     setModal(true);
@@ -84,18 +87,18 @@ void ImportExportDialog::setupUI()
     importLayout->addWidget(m_importUsersRadio);
     importLayout->addWidget(m_importFinesRadio);
     
-    QPushButton* importButton = new QPushButton("Импорт из JSON", this);
-    connect(importButton, &QPushButton::clicked, this, &ImportExportDialog::onImportClicked);
-    importLayout->addWidget(importButton);
+    m_importButton = new QPushButton("Импорт из JSON", this);
+    connect(m_importButton, &QPushButton::clicked, this, &ImportExportDialog::onImportClicked);
+    importLayout->addWidget(m_importButton);
     
     mainLayout->addWidget(importGroup);
     
     // Кнопка закрытия
     QHBoxLayout* buttonLayout = new QHBoxLayout();
     buttonLayout->addStretch();
-    QPushButton* closeButton = new QPushButton("Закрыть", this);
-    connect(closeButton, &QPushButton::clicked, this, &QDialog::accept);
-    buttonLayout->addWidget(closeButton);
+    m_closeButton = new QPushButton("Закрыть", this);
+    connect(m_closeButton, &QPushButton::clicked, this, &QDialog::accept);
+    buttonLayout->addWidget(m_closeButton);
     mainLayout->addLayout(buttonLayout);
 }
 
@@ -165,31 +168,63 @@ void ImportExportDialog::onImportClicked()
         return;
     }
     
-    ImportResult result;
-    
-    if (m_importAllRadio->isChecked()) {
-        result = m_importer->importFromJson(fileName, true);
-    } else if (m_importCarsRadio->isChecked()) {
-        result = m_importer->importCarsFromJson(fileName, true);
-    } else if (m_importRentalsRadio->isChecked()) {
-        result = m_importer->importRentalsFromJson(fileName, true);
-    } else if (m_importUsersRadio->isChecked()) {
-        result = m_importer->importUsersFromJson(fileName, true);
-    } else if (m_importFinesRadio->isChecked()) {
-        result = m_importer->importFinesFromJson(fileName, true);
+    int mode = m_importGroup->checkedId();
+    
+    // Копия импортера уходит в фоновую задачу; кнопки блокируются до завершения,
+    // чтобы окно администратора не перечитало данные посреди импорта
+    DataImporter importer = *m_importer;
+    m_importButton->setEnabled(false);
+    m_closeButton->setEnabled(false);
+    m_importButton->setText("Импорт...");
+    
+    m_importWatcher->setFuture(AsyncDatabase::getInstance().run<ImportResult>(QString(),
+        [importer, fileName, mode]() mutable -> ImportResult {
+            switch (mode) {
+            case 1:
+                return importer.importCarsFromJson(fileName, true);
+            case 2:
+                return importer.importRentalsFromJson(fileName, true);
+            case 3:
+                return importer.importUsersFromJson(fileName, true);
+            case 4:
+                return importer.importFinesFromJson(fileName, true);
+            default:
+                return importer.importFromJson(fileName, true);
+            }
+        }));
+}
+
+void ImportExportDialog::reject()
+{
+    // Пока идет импорт, окно не закрываем (Esc, кнопка закрытия окна)
+    if (m_importWatcher->isRunning()) {
+        return;
     }
+    QDialog::reject();
+}
+
+void ImportExportDialog::onImportFinished()
+{
+    m_importButton->setEnabled(true);
+    m_closeButton->setEnabled(true);
+    m_importButton->setText("Импорт из JSON");
+    
+    ImportResult result = m_importWatcher->result();
     
     QString message = QString("Импорт завершен:\n"
                             "Автомобилей: %1\n"
                             "Пользователей: %2\n"
                             "Аренд: %3\n"
                             "Штрафов: %4\n"
-                            "Ошибок: %5")
+                            "Ошибок: %5\n"
+                            "Время: %6 мс (%7 записей/с)")
                             .arg(result.carsImported)
                             .arg(result.usersImported)
                             .arg(result.rentalsImported)
                             .arg(result.finesImported)
-                            .arg(result.errors);
+                            .arg(result.errors)
+                            .arg(result.elapsedMs)
+                            .arg(result.recordsPerSecond(), 0, 'f', 0);
     
     if (!result.errorMessages.isEmpty()) {
         message += "\n\nОшибки:\n" + result.errorMessages.join("\n");
@@ -11,6 +11,7 @@
 #include <QLabel>
 #include <QFileDialog>
 #include <QMessageBox>
+#include <QFutureWatcher>
 #include "../utils/dataexporter.h"
 #include "../utils/dataimporter.h"
 #include "../database/databasemanager.h"
@@ -23,10 +24,14 @@ public:
     explicit ImportExportDialog(DatabaseManager* dbManager, QWidget *parent = nullptr);
     ~ImportExportDialog();
 
+protected:
+    void reject() override;
+
 private slots:
     void onExportClicked();
     void onImportClicked();
     void onExportReportClicked();
+    void onImportFinished();
 
 private:
     DatabaseManager* m_dbManager;
@@ -48,6 +53,12 @@ private:
     QRadioButton* m_importUsersRadio;
     QRadioButton* m_importFinesRadio;
     
+    QPushButton* m_importButton;
+    QPushButton* m_closeButton;
+    
+    // Импорт выполняется в фоновом потоке БД
+    QFutureWatcher<ImportResult>* m_importWatcher;
+    
     void setupUI();
     QString getExportFileName(const QString& defaultName);
     QString getImportFileName();
@@ -2,11 +2,12 @@
 #include "../utils/dateutils.h"
 #include <QMessageBox>
 
-RentalDialog::RentalDialog(const Car& car, int userId, PricingCalculator* calculator, QWidget *parent)
+RentalDialog::RentalDialog(const Car& car, int userId, PricingCalculator* calculator, QWidget *parent,
+                           const QDate& startDate, const QDate& endDate)
     : QDialog(parent), m_car(car), m_userId(userId), m_pricingCalculator(calculator)
 {
     m_rentalService = new RentalService();
-    setupUI();
+    setupUI(startDate, endDate);
     setWindowTitle("Оформление аренды");
     setModal(true);
     resize(450, 350);
@@ -17,7 +18,7 @@ RentalDialog::~RentalDialog()
     delete m_rentalService;
 }
 
-void RentalDialog::setupUI()
+void RentalDialog::setupUI(const QDate& startDate, const QDate& endDate)
 {
     QVBoxLayout* mainLayout = new QVBoxLayout(this);
     
@@ -33,12 +34,16 @@ void RentalDialog::setupUI()
     QGroupBox* datesGroup = new QGroupBox("Период аренды", this);
     QFormLayout* datesLayout = new QFormLayout(datesGroup);
     
-    m_startDateEdit = new QDateEdit(DateUtils::currentDate(), this);
+    QDate today = DateUtils::currentDate();
+    QDate initialStart = startDate.isValid() && startDate >= today ? startDate : today;
+    QDate initialEnd = endDate.isValid() && endDate > initialStart ? endDate : initialStart.addDays(1);
+    
+    m_startDateEdit = new QDateEdit(initialStart, this);
     m_startDateEdit->setCalendarPopup(true);
     m_startDateEdit->setMinimumDate(DateUtils::currentDate());
     datesLayout->addRow("Дата начала:", m_startDateEdit);
     
-    m_endDateEdit = new QDateEdit(DateUtils::currentDate().addDays(1), this);
+    m_endDateEdit = new QDateEdit(initialEnd, this);
     m_endDateEdit->setCalendarPopup(true);
     m_endDateEdit->setMinimumDate(DateUtils::currentDate().addDays(1));
     datesLayout->addRow("Дата окончания:", m_endDateEdit);
@@ -18,7 +18,9 @@ class RentalDialog : public QDialog
     Q_OBJECT
 
 public:
-    explicit RentalDialog(const Car& car, int userId, PricingCalculator* calculator, QWidget *parent = nullptr);
+    // startDate/endDate - начальный период (невалидные даты - сегодня и завтра)
+    explicit RentalDialog(const Car& car, int userId, PricingCalculator* calculator, QWidget *parent = nullptr,
+                          const QDate& startDate = QDate(), const QDate& endDate = QDate());
     ~RentalDialog();
 
 private slots:
@@ -37,7 +39,7 @@ private:
     QLabel* m_costLabel;
     QLabel* m_calculationInfoLabel;
     
-    void setupUI();
+    void setupUI(const QDate& startDate, const QDate& endDate);
     void calculateCost();
     int getDays() const;
 };
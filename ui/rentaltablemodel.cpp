@@ -0,0 +1,142 @@
+#include "rentaltablemodel.h"
+#include "../utils/dateutils.h"
+
+RentalTableModel::RentalTableModel(const QList<Column>& columns, QObject* parent)
+    : QAbstractTableModel(parent), m_columns(columns)
+{
+}
+
+int RentalTableModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_ids.size();
+}
+
+int RentalTableModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_columns.size();
+}
+
+QVariant RentalTableModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_ids.size() || index.column() >= m_columns.size() ||
+        role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    
+    int row = index.row();
+    switch (m_columns[index.column()]) {
+    case IdColumn:
+        return m_ids[row];
+    case ClientColumn:
+        return m_usernames[row];
+    case CarColumn:
+        return m_carNames[row];
+    case StartDateColumn:
+        return QDate::fromJulianDay(m_startDays[row]).toString("dd.MM.yyyy");
+    case EndDateColumn:
+        return QDate::fromJulianDay(m_endDays[row]).toString("dd.MM.yyyy");
+    case CostColumn:
+        return QString::number(m_costs[row], 'f', 2) + " руб";
+    case StatusColumn:
+        return m_completed[row] ? "Завершена" : "Активна";
+    case OverdueColumn:
+        return overdueText(row);
+    default:
+        return QVariant();
+    }
+}
+
+QVariant RentalTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole || section < 0 || section >= m_columns.size()) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    
+    switch (m_columns[section]) {
+    case IdColumn: return "ID";
+    case ClientColumn: return "Клиент";
+    case CarColumn: return "Автомобиль";
+    case StartDateColumn: return "Начало";
+    case EndDateColumn: return "Окончание";
+    case CostColumn: return "Стоимость";
+    case StatusColumn: return "Статус";
+    case OverdueColumn: return "Просрочка";
+    default: return QVariant();
+    }
+}
+
+void RentalTableModel::setRentals(const QList<RentalView>& rentals)
+{
+    beginResetModel();
+    m_ids.clear();
+    m_usernames.clear();
+    m_carNames.clear();
+    m_startDays.clear();
+    m_endDays.clear();
+    m_costs.clear();
+    m_fines.clear();
+    m_completed.clear();
+    m_ids.reserve(rentals.size());
+    m_usernames.reserve(rentals.size());
+    m_carNames.reserve(rentals.size());
+    m_startDays.reserve(rentals.size());
+    m_endDays.reserve(rentals.size());
+    m_costs.reserve(rentals.size());
+    m_fines.reserve(rentals.size());
+    m_completed.reserve(rentals.size());
+    for (const RentalView& rental : rentals) {
+        appendRow(rental);
+    }
+    endResetModel();
+}
+
+void RentalTableModel::appendRentals(const QList<RentalView>& rentals)
+{
+    if (rentals.isEmpty()) {
+        return;
+    }
+    
+    int first = m_ids.size();
+    beginInsertRows(QModelIndex(), first, first + rentals.size() - 1);
+    for (const RentalView& rental : rentals) {
+        appendRow(rental);
+    }
+    endInsertRows();
+}
+
+int RentalTableModel::getRentalId(int row) const
+{
+    return (row >= 0 && row < m_ids.size()) ? m_ids[row] : 0;
+}
+
+void RentalTableModel::appendRow(const RentalView& rental)
+{
+    const Rental& r = rental.getRental();
+    m_ids.append(r.getId());
+    m_usernames.append(rental.getUsername());
+    m_carNames.append(rental.getCarFullName());
+    m_startDays.append(r.getStartDate().toJulianDay());
+    m_endDays.append(r.getEndDate().toJulianDay());
+    m_costs.append(r.getTotalCost());
+    m_fines.append(rental.getTotalFines());
+    m_completed.append(r.isCompleted());
+}
+
+QString RentalTableModel::overdueText(int row) const
+{
+    if (m_completed[row]) {
+        return "-";
+    }
+    
+    // Как Rental::getDaysOverdue: дни после даты окончания по текущей дате
+    qint64 overdueDays = DateUtils::currentDate().toJulianDay() - m_endDays[row];
+    if (overdueDays <= 0) {
+        return "В срок";
+    }
+    
+    QString text = QString("Просрочка: %1 дн.").arg(overdueDays);
+    if (m_fines[row] > 0) {
+        text += QString(" (штраф: %1 руб)").arg(m_fines[row], 0, 'f', 2);
+    }
+    return text;
+}
@@ -0,0 +1,60 @@
+#ifndef RENTALTABLEMODEL_H
+#define RENTALTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QVector>
+#include <QList>
+#include "../models/rentalview.h"
+
+// Модель таблицы аренд для QTableView.
+// Набор и порядок колонок задается при создании (окно администратора и клиента показывают разные).
+// Данные хранятся по колонкам: даты - номерами дней, суммы - числами; текст ячейки
+// формируется в data() только для видимых строк, поэтому память и время загрузки
+// не зависят от числа колонок и формата, а QTableView прокручивает миллионы строк
+class RentalTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        IdColumn,
+        ClientColumn,
+        CarColumn,
+        StartDateColumn,
+        EndDateColumn,
+        CostColumn,
+        StatusColumn,
+        OverdueColumn
+    };
+    
+    explicit RentalTableModel(const QList<Column>& columns, QObject* parent = nullptr);
+    
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    
+    // Заменить все строки
+    void setRentals(const QList<RentalView>& rentals);
+    // Добавить строки в конец (следующая страница)
+    void appendRentals(const QList<RentalView>& rentals);
+    
+    // ID аренды в строке, 0 - строка вне диапазона
+    int getRentalId(int row) const;
+
+private:
+    void appendRow(const RentalView& rental);
+    QString overdueText(int row) const;
+    
+    QList<Column> m_columns;
+    QVector<int> m_ids;
+    QVector<QString> m_usernames;
+    QVector<QString> m_carNames;
+    QVector<qint64> m_startDays;
+    QVector<qint64> m_endDays;
+    QVector<double> m_costs;
+    QVector<double> m_fines;
+    QVector<bool> m_completed;
+};
+
+#endif // RENTALTABLEMODEL_H
@@ -1,11 +1,17 @@
 #include "reportswindow.h"
 #include "../utils/dateutils.h"
+#include "../database/asyncdatabase.h"
 #include <QHeaderView>
 #include <QMessageBox>
 
 ReportsWindow::ReportsWindow(ReportManager* reportManager, QWidget *parent)
     : QMainWindow(parent), m_reportManager(reportManager)
 {
+    // Канал фоновых запросов этого окна: новый отчет вытесняет незавершенный предыдущий
+    m_reportChannel = QString("reports/%1").arg(reinterpret_cast<quintptr>(this));
+    m_reportWatcher = new QFutureWatcher<PeriodReport>(this);
+    connect(m_reportWatcher, &QFutureWatcher<PeriodReport>::finished, this, &ReportsWindow::onReportReady);
+    
     setupUI();
     setWindowTitle("Отчеты и статистика");
     resize(800, 600);
@@ -19,6 +25,8 @@ ReportsWindow::ReportsWindow(ReportManager* reportManager, QWidget *parent)
 
 ReportsWindow::~ReportsWindow()
 {
+    // Результат больше некому показывать
+    AsyncDatabase::getInstance().cancel(m_reportChannel);
 }
 
 void ReportsWindow::setupUI()
@@ -39,9 +47,9 @@ void ReportsWindow::setupUI()
     m_endDateEdit->setCalendarPopup(true);
     periodLayout->addRow("Дата окончания:", m_endDateEdit);
     
-    QPushButton* generateButton = new QPushButton("Сформировать отчет", this);
-    connect(generateButton, &QPushButton::clicked, this, &ReportsWindow::onGenerateReport);
-    periodLayout->addRow("", generateButton);
+    m_generateButton = new QPushButton("Сформировать отчет", this);
+    connect(m_generateButton, &QPushButton::clicked, this, &ReportsWindow::onGenerateReport);
+    periodLayout->addRow("", m_generateButton);
     
     mainLayout->addWidget(periodGroup);
     
@@ -102,7 +110,25 @@ void ReportsWindow::generateReport()
         return;
     }
     
-    RevenueReport report = m_reportManager->generateRevenueReport(startDate, endDate);
+    // Копия менеджера отчетов уходит в фоновую задачу: окно может закрыться раньше, чем она завершится
+    ReportManager reportManager = *m_reportManager;
+    m_generateButton->setText("Формирование...");
+    m_reportWatcher->setFuture(AsyncDatabase::getInstance().run<PeriodReport>(m_reportChannel,
+        [reportManager, startDate, endDate]() mutable {
+            return reportManager.generatePeriodReport(startDate, endDate, ReportManager::DEFAULT_POPULAR_LIMIT);
+        }));
+}
+
+void ReportsWindow::onReportReady()
+{
+    // Отмененный (вытесненный более новым) запрос не отображаем
+    if (m_reportWatcher->isCanceled()) {
+        return;
+    }
+    m_generateButton->setText("Сформировать отчет");
+    
+    PeriodReport result = m_reportWatcher->result();
+    const RevenueReport& report = result.revenue;
     
     m_totalRevenueLabel->setText(QString("Общий доход: %1 руб").arg(report.totalRevenue, 0, 'f', 2));
     m_totalFinesLabel->setText(QString("Доход от штрафов: %1 руб").arg(report.totalFines, 0, 'f', 2));
@@ -112,7 +138,7 @@ void ReportsWindow::generateReport()
     m_fleetUtilizationLabel->setText(QString("Загруженность парка: %1%").arg(report.fleetUtilization, 0, 'f', 1));
     
     // Популярные автомобили
-    QList<CarStatistics> popularCars = m_reportManager->getPopularCars(startDate, endDate, 10);
+    const QList<CarStatistics>& popularCars = result.popularCars;
     m_popularCarsTable->setRowCount(popularCars.size());
     
     for (int i = 0; i < popularCars.size(); ++i) {
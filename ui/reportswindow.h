@@ -10,6 +10,7 @@
 #include <QHBoxLayout>
 #include <QGroupBox>
 #include <QFormLayout>
+#include <QFutureWatcher>
 #include "../managers/reportmanager.h"
 
 class ReportsWindow : public QMainWindow
@@ -23,6 +24,7 @@ public:
 private slots:
     void onGenerateReport();
     void onRefresh();
+    void onReportReady();
 
 private:
     ReportManager* m_reportManager;
@@ -36,6 +38,11 @@ private:
     QLabel* m_avgDurationLabel;
     QLabel* m_fleetUtilizationLabel;
     QTableWidget* m_popularCarsTable;
+    QPushButton* m_generateButton;
+    
+    // Отчет формируется в фоне, чтобы окно не зависало на больших данных
+    QFutureWatcher<PeriodReport>* m_reportWatcher;
+    QString m_reportChannel;
     
     void setupUI();
     void generateReport();
@@ -0,0 +1,12 @@
+#include "tableviewutils.h"
+#include <QTableView>
+#include <QHeaderView>
+
+void TableViewUtils::setupRecordTable(QTableView* table)
+{
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->setSelectionMode(QAbstractItemView::SingleSelection);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->horizontalHeader()->setStretchLastSection(true);
+    table->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+}
@@ -0,0 +1,24 @@
+#ifndef TABLEVIEWUTILS_H
+#define TABLEVIEWUTILS_H
+
+class QTableView;
+
+/**
+ * Общая настройка таблиц записей (автомобили, аренды, пользователи)
+ */
+class TableViewUtils
+{
+public:
+    /**
+     * Таблица только для просмотра с выбором одной строки целиком.
+     * Высота строк фиксирована: представлению не нужно измерять каждую строку,
+     * поэтому прокрутка больших моделей не зависит от числа строк
+     * @param table Таблица, у которой уже установлена модель
+     */
+    static void setupRecordTable(QTableView* table);
+
+private:
+    TableViewUtils() = default; // Утилитный класс, не создается
+};
+
+#endif // TABLEVIEWUTILS_H
@@ -0,0 +1,76 @@
+#include "usertablemodel.h"
+
+UserTableModel::UserTableModel(QObject* parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+int UserTableModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_ids.size();
+}
+
+int UserTableModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant UserTableModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_ids.size() || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    
+    int row = index.row();
+    switch (index.column()) {
+    case IdColumn:
+        return m_ids[row];
+    case UsernameColumn:
+        return m_usernames[row];
+    case RoleColumn:
+        return User::roleToString(m_roles[row]);
+    default:
+        return QVariant();
+    }
+}
+
+QVariant UserTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    
+    switch (section) {
+    case IdColumn: return "ID";
+    case UsernameColumn: return "Логин";
+    case RoleColumn: return "Роль";
+    default: return QVariant();
+    }
+}
+
+void UserTableModel::setUsers(const QList<User>& users)
+{
+    beginResetModel();
+    m_ids.clear();
+    m_usernames.clear();
+    m_roles.clear();
+    m_ids.reserve(users.size());
+    m_usernames.reserve(users.size());
+    m_roles.reserve(users.size());
+    for (const User& user : users) {
+        appendRow(user);
+    }
+    endResetModel();
+}
+
+int UserTableModel::getUserId(int row) const
+{
+    return (row >= 0 && row < m_ids.size()) ? m_ids[row] : 0;
+}
+
+void UserTableModel::appendRow(const User& user)
+{
+    m_ids.append(user.getId());
+    m_usernames.append(user.getUsername());
+    m_roles.append(user.getRole());
+}
@@ -0,0 +1,42 @@
+#ifndef USERTABLEMODEL_H
+#define USERTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QVector>
+#include <QList>
+#include "../models/user.h"
+
+// Модель таблицы пользователей для QTableView (хранение по колонкам, форматирование в data())
+class UserTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        IdColumn,
+        UsernameColumn,
+        RoleColumn,
+        ColumnCount
+    };
+    
+    explicit UserTableModel(QObject* parent = nullptr);
+    
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    
+    void setUsers(const QList<User>& users);
+    
+    // ID пользователя в строке, 0 - строка вне диапазона
+    int getUserId(int row) const;
+
+private:
+    void appendRow(const User& user);
+    
+    QVector<int> m_ids;
+    QVector<QString> m_usernames;
+    QVector<UserRole> m_roles;
+};
+
+#endif // USERTABLEMODEL_H
@@ -1,5 +1,6 @@
 #include "dataexporter.h"
 #include "dateutils.h"
+#include "jsonstreamwriter.h"
 #include <QFile>
 #include <QJsonObject>
 #include <QJsonArray>
@@ -19,177 +20,119 @@ bool DataExporter::exportToJson(const QString& filePath)
         return false;
     }
     
-    QJsonObject root;
-    
-    // Метаданные
-    root["metadata"] = createMetadata();
-    root["export_date"] = DateUtils::currentDate().toString("yyyy-MM-dd");
-    root["version"] = "1.0";
-    
-    // Автомобили
-    QJsonArray carsArray;
-    QList<Car> cars = m_dbManager->getAllCars();
-    for (const Car& car : cars) {
-        carsArray.append(carToJson(car));
-    }
-    root["cars"] = carsArray;
-    
-    // Пользователи
-    QJsonArray usersArray;
-    QList<User> users = m_dbManager->getAllUsers();
-    for (const User& user : users) {
-        usersArray.append(userToJson(user));
-    }
-    root["users"] = usersArray;
-    
-    // Аренды
-    QJsonArray rentalsArray;
-    QList<Rental> rentals = m_dbManager->getAllRentals();
-    for (const Rental& rental : rentals) {
-        rentalsArray.append(rentalToJson(rental));
-    }
-    root["rentals"] = rentalsArray;
-    
-    // Штрафы
-    QJsonArray finesArray;
-    QList<Fine> fines = m_dbManager->getAllFines();
-    for (const Fine& fine : fines) {
-        finesArray.append(fineToJson(fine));
-    }
-    root["fines"] = finesArray;
-    
-    // Сохранение в файл
-    QJsonDocument doc(root);
     QFile file(filePath);
     if (!file.open(QIODevice::WriteOnly)) {
         qDebug() << "Не удалось открыть файл для записи:" << filePath;
         return false;
     }
     
-    file.write(doc.toJson(QJsonDocument::Indented));
+    JsonStreamWriter writer(&file);
+    writer.beginObject();
+    
+    // Метаданные
+    writer.writeField("metadata", createMetadata());
+    writer.writeField("export_date", DateUtils::currentDate().toString("yyyy-MM-dd"));
+    writer.writeField("version", "1.0");
+    
+    // Таблицы выгружаются построчно, без промежуточных списков
+    bool ok = writeCars(writer)
+              && writeUsers(writer)
+              && writeRentals(writer)
+              && writeFines(writer);
+    
+    writer.endObject();
     file.close();
     
-    return true;
+    return ok && writer.isOk();
 }
 
 bool DataExporter::exportCarsToJson(const QString& filePath)
 {
-    if (!m_dbManager) {
-        return false;
-    }
-    
-    QJsonObject root;
-    root["metadata"] = createMetadata();
-    root["export_date"] = DateUtils::currentDate().toString("yyyy-MM-dd");
-    root["type"] = "cars";
-    
-    QJsonArray carsArray;
-    QList<Car> cars = m_dbManager->getAllCars();
-    for (const Car& car : cars) {
-        carsArray.append(carToJson(car));
-    }
-    root["cars"] = carsArray;
-    
-    QJsonDocument doc(root);
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly)) {
-        return false;
-    }
-    
-    file.write(doc.toJson(QJsonDocument::Indented));
-    file.close();
-    
-    return true;
+    return exportSection(filePath, "cars", &DataExporter::writeCars);
 }
 
 bool DataExporter::exportRentalsToJson(const QString& filePath)
 {
-    if (!m_dbManager) {
-        return false;
-    }
-    
-    QJsonObject root;
-    root["metadata"] = createMetadata();
-    root["export_date"] = DateUtils::currentDate().toString("yyyy-MM-dd");
-    root["type"] = "rentals";
-    
-    QJsonArray rentalsArray;
-    QList<Rental> rentals = m_dbManager->getAllRentals();
-    for (const Rental& rental : rentals) {
-        rentalsArray.append(rentalToJson(rental));
-    }
-    root["rentals"] = rentalsArray;
-    
-    QJsonDocument doc(root);
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly)) {
-        return false;
-    }
-    
-    file.write(doc.toJson(QJsonDocument::Indented));
-    file.close();
-    
-    return true;
+    return exportSection(filePath, "rentals", &DataExporter::writeRentals);
 }
 
 bool DataExporter::exportUsersToJson(const QString& filePath)
 {
-    if (!m_dbManager) {
-        return false;
-    }
-    
-    QJsonObject root;
-    root["metadata"] = createMetadata();
-    root["export_date"] = DateUtils::currentDate().toString("yyyy-MM-dd");
-    root["type"] = "users";
-    
-    QJsonArray usersArray;
-    QList<User> users = m_dbManager->getAllUsers();
-    for (const User& user : users) {
-        usersArray.append(userToJson(user));
-    }
-    root["users"] = usersArray;
-    
-    QJsonDocument doc(root);
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly)) {
-        return false;
-    }
-    
-    file.write(doc.toJson(QJsonDocument::Indented));
-    file.close();
-    
-    return true;
+    return exportSection(filePath, "users", &DataExporter::writeUsers);
 }
 
 bool DataExporter::exportFinesToJson(const QString& filePath)
+{
+    return exportSection(filePath, "fines", &DataExporter::writeFines);
+}
+
+bool DataExporter::exportSection(const QString& filePath, const QString& type, SectionWriter sectionWriter)
 {
     if (!m_dbManager) {
         return false;
     }
     
-    QJsonObject root;
-    root["metadata"] = createMetadata();
-    root["export_date"] = DateUtils::currentDate().toString("yyyy-MM-dd");
-    root["type"] = "fines";
-    
-    QJsonArray finesArray;
-    QList<Fine> fines = m_dbManager->getAllFines();
-    for (const Fine& fine : fines) {
-        finesArray.append(fineToJson(fine));
-    }
-    root["fines"] = finesArray;
-    
-    QJsonDocument doc(root);
     QFile file(filePath);
     if (!file.open(QIODevice::WriteOnly)) {
         return false;
     }
     
-    file.write(doc.toJson(QJsonDocument::Indented));
+    JsonStreamWriter writer(&file);
+    writer.beginObject();
+    writer.writeField("metadata", createMetadata());
+    writer.writeField("export_date", DateUtils::currentDate().toString("yyyy-MM-dd"));
+    writer.writeField("type", type);
+    
+    bool ok = (this->*sectionWriter)(writer);
+    
+    writer.endObject();
     file.close();
     
-    return true;
+    return ok && writer.isOk();
+}
+
+bool DataExporter::writeCars(JsonStreamWriter& writer)
+{
+    writer.beginArray("cars");
+    bool ok = m_dbManager->forEachCar(RowFilter(), [this, &writer](const Car& car) {
+        writer.writeElement(carToJson(car));
+        return writer.isOk();
+    });
+    writer.endArray();
+    return ok;
+}
+
+bool DataExporter::writeUsers(JsonStreamWriter& writer)
+{
+    writer.beginArray("users");
+    bool ok = m_dbManager->forEachUser(RowFilter(), [this, &writer](const User& user) {
+        writer.writeElement(userToJson(user));
+        return writer.isOk();
+    });
+    writer.endArray();
+    return ok;
+}
+
+bool DataExporter::writeRentals(JsonStreamWriter& writer)
+{
+    writer.beginArray("rentals");
+    bool ok = m_dbManager->forEachRental(RowFilter(), [this, &writer](const Rental& rental) {
+        writer.writeElement(rentalToJson(rental));
+        return writer.isOk();
+    });
+    writer.endArray();
+    return ok;
+}
+
+bool DataExporter::writeFines(JsonStreamWriter& writer)
+{
+    writer.beginArray("fines");
+    bool ok = m_dbManager->forEachFine(RowFilter(), [this, &writer](const Fine& fine) {
+        writer.writeElement(fineToJson(fine));
+        return writer.isOk();
+    });
+    writer.endArray();
+    return ok;
 }
 
 bool DataExporter::exportReportToJson(const QString& filePath, const QDate& startDate, const QDate& endDate)
@@ -11,6 +11,8 @@
 #include "../models/fine.h"
 #include "../database/databasemanager.h"
 
+class JsonStreamWriter;
+
 class DataExporter
 {
 public:
@@ -37,6 +39,14 @@ public:
 private:
     DatabaseManager* m_dbManager;
     
+    // Запись одного массива таблицы; false при ошибке чтения БД
+    typedef bool (DataExporter::*SectionWriter)(JsonStreamWriter& writer);
+    bool exportSection(const QString& filePath, const QString& type, SectionWriter sectionWriter);
+    bool writeCars(JsonStreamWriter& writer);
+    bool writeUsers(JsonStreamWriter& writer);
+    bool writeRentals(JsonStreamWriter& writer);
+    bool writeFines(JsonStreamWriter& writer);
+    
     QJsonObject carToJson(const Car& car);
     QJsonObject rentalToJson(const Rental& rental);
     QJsonObject userToJson(const User& user);
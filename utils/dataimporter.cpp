@@ -9,12 +9,19 @@
 #include <QJsonArray>
 #include <QDebug>
 #include <QDate>
+#include <QSet>
+#include <QElapsedTimer>
 
 DataImporter::DataImporter(DatabaseManager* dbManager)
-    : m_dbManager(dbManager)
+    : m_dbManager(dbManager), m_batchSize(DEFAULT_BATCH_SIZE)
 {
 }
 
+void DataImporter::setBatchSize(int batchSize)
+{
+    m_batchSize = qMax(0, batchSize);
+}
+
 ImportResult DataImporter::importFromJson(const QString& filePath, bool skipExisting)
 {
     ImportResult result;
@@ -25,6 +32,9 @@ ImportResult DataImporter::importFromJson(const QString& filePath, bool skipExis
         return result;
     }
     
+    QElapsedTimer timer;
+    timer.start();
+    
     QFile file(filePath);
     if (!file.open(QIODevice::ReadOnly)) {
         result.errors++;
@@ -52,107 +62,97 @@ ImportResult DataImporter::importFromJson(const QString& filePath, bool skipExis
         return result;
     }
     
+    bool ok = true;
+    
     // Импорт автомобилей
-    if (root.contains("cars") && root["cars"].isArray()) {
-        QJsonArray carsArray = root["cars"].toArray();
-        for (const QJsonValue& value : carsArray) {
-            if (value.isObject()) {
-                Car car = jsonToCar(value.toObject());
-                if (car.getId() > 0) {
-                    // Проверяем существование
-                    Car existing = m_dbManager->getCarById(car.getId());
-                    if (existing.getId() == 0 || !skipExisting) {
-                        if (existing.getId() > 0) {
-                            m_dbManager->updateCar(car);
-                        } else {
-                            car.setId(0); // Сбрасываем ID для нового автомобиля
-                            if (m_dbManager->addCar(car)) {
-                                result.carsImported++;
-                            } else {
-                                result.errors++;
-                            }
-                        }
-                    }
-                }
+    if (ok && root.contains("cars") && root["cars"].isArray()) {
+        QSet<int> existingIds = existingCarIds();
+        ok = importSection(root["cars"].toArray(), "cars", [this, &existingIds, skipExisting](const QJsonObject& obj) -> RecordOutcome {
+            Car car = jsonToCar(obj);
+            if (car.getId() <= 0) {
+                return RecordOutcome::Skipped;
             }
-        }
+            bool exists = existingIds.contains(car.getId());
+            if (exists && skipExisting) {
+                return RecordOutcome::Skipped;
+            }
+            if (exists) {
+                m_dbManager->updateCar(car);
+                return RecordOutcome::Skipped;
+            }
+            car.setId(0); // Сбрасываем ID для нового автомобиля
+            return m_dbManager->addCar(car) ? RecordOutcome::Imported : RecordOutcome::Failed;
+        }, result.carsImported, result);
     }
     
     // Импорт пользователей
-    if (root.contains("users") && root["users"].isArray()) {
-        QJsonArray usersArray = root["users"].toArray();
-        for (const QJsonValue& value : usersArray) {
-            if (value.isObject()) {
-                User user = jsonToUser(value.toObject());
-                if (!user.getUsername().isEmpty()) {
-                    User existing = m_dbManager->getUserByUsername(user.getUsername());
-                    if (existing.getId() == 0 || !skipExisting) {
-                        if (existing.getId() > 0) {
-                            m_dbManager->updateUser(user);
-                        } else {
-                            user.setId(0);
-                            if (m_dbManager->addUser(user)) {
-                                result.usersImported++;
-                            } else {
-                                result.errors++;
-                            }
-                        }
-                    }
-                }
+    if (ok && root.contains("users") && root["users"].isArray()) {
+        QSet<QString> existingNames = existingUsernames();
+        ok = importSection(root["users"].toArray(), "users", [this, &existingNames, skipExisting](const QJsonObject& obj) -> RecordOutcome {
+            User user = jsonToUser(obj);
+            if (user.getUsername().isEmpty()) {
+                return RecordOutcome::Skipped;
             }
-        }
+            bool exists = existingNames.contains(user.getUsername());
+            if (exists && skipExisting) {
+                return RecordOutcome::Skipped;
+            }
+            if (exists) {
+                m_dbManager->updateUser(user);
+                return RecordOutcome::Skipped;
+            }
+            user.setId(0);
+            if (!m_dbManager->addUser(user)) {
+                return RecordOutcome::Failed;
+            }
+            existingNames.insert(user.getUsername());
+            return RecordOutcome::Imported;
+        }, result.usersImported, result);
     }
     
     // Импорт аренд
-    if (root.contains("rentals") && root["rentals"].isArray()) {
-        QJsonArray rentalsArray = root["rentals"].toArray();
-        for (const QJsonValue& value : rentalsArray) {
-            if (value.isObject()) {
-                Rental rental = jsonToRental(value.toObject());
-                if (rental.getId() > 0) {
-                    Rental existing = m_dbManager->getRentalById(rental.getId());
-                    if (existing.getId() == 0 || !skipExisting) {
-                        if (existing.getId() > 0) {
-                            m_dbManager->updateRental(rental);
-                        } else {
-                            rental.setId(0);
-                            if (m_dbManager->addRental(rental)) {
-                                result.rentalsImported++;
-                            } else {
-                                result.errors++;
-                            }
-                        }
-                    }
-                }
+    if (ok && root.contains("rentals") && root["rentals"].isArray()) {
+        QSet<int> existingIds = existingRentalIds();
+        ok = importSection(root["rentals"].toArray(), "rentals", [this, &existingIds, skipExisting](const QJsonObject& obj) -> RecordOutcome {
+            Rental rental = jsonToRental(obj);
+            if (rental.getId() <= 0) {
+                return RecordOutcome::Skipped;
             }
-        }
+            bool exists = existingIds.contains(rental.getId());
+            if (exists && skipExisting) {
+                return RecordOutcome::Skipped;
+            }
+            if (exists) {
+                m_dbManager->updateRental(rental);
+                return RecordOutcome::Skipped;
+            }
+            rental.setId(0);
+            return m_dbManager->addRental(rental) ? RecordOutcome::Imported : RecordOutcome::Failed;
+        }, result.rentalsImported, result);
     }
     
     // Импорт штрафов
-    if (root.contains("fines") && root["fines"].isArray()) {
-        QJsonArray finesArray = root["fines"].toArray();
-        for (const QJsonValue& value : finesArray) {
-            if (value.isObject()) {
-                Fine fine = jsonToFine(value.toObject());
-                if (fine.getId() > 0) {
-                    Fine existing = m_dbManager->getFineById(fine.getId());
-                    if (existing.getId() == 0 || !skipExisting) {
-                        if (existing.getId() > 0) {
-                            m_dbManager->updateFine(fine);
-                        } else {
-                            fine.setId(0);
-                            if (m_dbManager->addFine(fine)) {
-                                result.finesImported++;
-                            } else {
-                                result.errors++;
-                            }
-                        }
-                    }
-                }
+    if (ok && root.contains("fines") && root["fines"].isArray()) {
+        QSet<int> existingIds = existingFineIds();
+        ok = importSection(root["fines"].toArray(), "fines", [this, &existingIds, skipExisting](const QJsonObject& obj) -> RecordOutcome {
+            Fine fine = jsonToFine(obj);
+            if (fine.getId() <= 0) {
+                return RecordOutcome::Skipped;
             }
-        }
+            bool exists = existingIds.contains(fine.getId());
+            if (exists && skipExisting) {
+                return RecordOutcome::Skipped;
+            }
+            if (exists) {
+                m_dbManager->updateFine(fine);
+                return RecordOutcome::Skipped;
+            }
+            fine.setId(0);
+            return m_dbManager->addFine(fine) ? RecordOutcome::Imported : RecordOutcome::Failed;
+        }, result.finesImported, result);
     }
     
+    result.elapsedMs = timer.elapsed();
     return result;
 }
 
@@ -160,6 +160,9 @@ ImportResult DataImporter::importCarsFromJson(const QString& filePath, bool skip
 {
     ImportResult result;
     
+    QElapsedTimer timer;
+    timer.start();
+    
     QFile file(filePath);
     if (!file.open(QIODevice::ReadOnly)) {
         result.errors++;
@@ -172,25 +175,18 @@ ImportResult DataImporter::importCarsFromJson(const QString& filePath, bool skip
     
     QJsonObject root = doc.object();
     if (root.contains("cars") && root["cars"].isArray()) {
-        QJsonArray carsArray = root["cars"].toArray();
-        for (const QJsonValue& value : carsArray) {
-            if (value.isObject()) {
-                Car car = jsonToCar(value.toObject());
-                if (car.getId() > 0) {
-                    Car existing = m_dbManager->getCarById(car.getId());
-                    if (existing.getId() == 0 || !skipExisting) {
-                        car.setId(0);
-                        if (m_dbManager->addCar(car)) {
-                            result.carsImported++;
-                        } else {
-                            result.errors++;
-                        }
-                    }
-                }
+        QSet<int> existingIds = existingCarIds();
+        importSection(root["cars"].toArray(), "cars", [this, &existingIds, skipExisting](const QJsonObject& obj) -> RecordOutcome {
+            Car car = jsonToCar(obj);
+            if (car.getId() <= 0 || (existingIds.contains(car.getId()) && skipExisting)) {
+                return RecordOutcome::Skipped;
             }
-        }
+            car.setId(0);
+            return m_dbManager->addCar(car) ? RecordOutcome::Imported : RecordOutcome::Failed;
+        }, result.carsImported, result);
     }
     
+    result.elapsedMs = timer.elapsed();
     return result;
 }
 
@@ -198,6 +194,9 @@ ImportResult DataImporter::importUsersFromJson(const QString& filePath, bool ski
 {
     ImportResult result;
     
+    QElapsedTimer timer;
+    timer.start();
+    
     QFile file(filePath);
     if (!file.open(QIODevice::ReadOnly)) {
         result.errors++;
@@ -209,25 +208,22 @@ ImportResult DataImporter::importUsersFromJson(const QString& filePath, bool ski
     
     QJsonObject root = doc.object();
     if (root.contains("users") && root["users"].isArray()) {
-        QJsonArray usersArray = root["users"].toArray();
-        for (const QJsonValue& value : usersArray) {
-            if (value.isObject()) {
-                User user = jsonToUser(value.toObject());
-                if (!user.getUsername().isEmpty()) {
-                    User existing = m_dbManager->getUserByUsername(user.getUsername());
-                    if (existing.getId() == 0 || !skipExisting) {
-                        user.setId(0);
-                        if (m_dbManager->addUser(user)) {
-                            result.usersImported++;
-                        } else {
-                            result.errors++;
-                        }
-                    }
-                }
+        QSet<QString> existingNames = existingUsernames();
+        importSection(root["users"].toArray(), "users", [this, &existingNames, skipExisting](const QJsonObject& obj) -> RecordOutcome {
+            User user = jsonToUser(obj);
+            if (user.getUsername().isEmpty() || (existingNames.contains(user.getUsername()) && skipExisting)) {
+                return RecordOutcome::Skipped;
             }
-        }
+            user.setId(0);
+            if (!m_dbManager->addUser(user)) {
+                return RecordOutcome::Failed;
+            }
+            existingNames.insert(user.getUsername());
+            return RecordOutcome::Imported;
+        }, result.usersImported, result);
     }
     
+    result.elapsedMs = timer.elapsed();
     return result;
 }
 
@@ -235,6 +231,9 @@ ImportResult DataImporter::importRentalsFromJson(const QString& filePath, bool s
 {
     ImportResult result;
     
+    QElapsedTimer timer;
+    timer.start();
+    
     QFile file(filePath);
     if (!file.open(QIODevice::ReadOnly)) {
         result.errors++;
@@ -246,22 +245,17 @@ ImportResult DataImporter::importRentalsFromJson(const QString& filePath, bool s
     
     QJsonObject root = doc.object();
     if (root.contains("rentals") && root["rentals"].isArray()) {
-        QJsonArray rentalsArray = root["rentals"].toArray();
-        for (const QJsonValue& value : rentalsArray) {
-            if (value.isObject()) {
-                Rental rental = jsonToRental(value.toObject());
-                if (rental.getId() > 0) {
-                    rental.setId(0);
-                    if (m_dbManager->addRental(rental)) {
-                        result.rentalsImported++;
-                    } else {
-                        result.errors++;
-                    }
-                }
+        importSection(root["rentals"].toArray(), "rentals", [this](const QJsonObject& obj) -> RecordOutcome {
+            Rental rental = jsonToRental(obj);
+            if (rental.getId() <= 0) {
+                return RecordOutcome::Skipped;
             }
-        }
+            rental.setId(0);
+            return m_dbManager->addRental(rental) ? RecordOutcome::Imported : RecordOutcome::Failed;
+        }, result.rentalsImported, result);
     }
     
+    result.elapsedMs = timer.elapsed();
     return result;
 }
 
@@ -269,6 +263,9 @@ ImportResult DataImporter::importFinesFromJson(const QString& filePath, bool ski
 {
     ImportResult result;
     
+    QElapsedTimer timer;
+    timer.start();
+    
     QFile file(filePath);
     if (!file.open(QIODevice::ReadOnly)) {
         result.errors++;
@@ -280,25 +277,125 @@ ImportResult DataImporter::importFinesFromJson(const QString& filePath, bool ski
     
     QJsonObject root = doc.object();
     if (root.contains("fines") && root["fines"].isArray()) {
-        QJsonArray finesArray = root["fines"].toArray();
-        for (const QJsonValue& value : finesArray) {
-            if (value.isObject()) {
-                Fine fine = jsonToFine(value.toObject());
-                if (fine.getId() > 0) {
-                    fine.setId(0);
-                    if (m_dbManager->addFine(fine)) {
-                        result.finesImported++;
-                    } else {
-                        result.errors++;
-                    }
-                }
+        importSection(root["fines"].toArray(), "fines", [this](const QJsonObject& obj) -> RecordOutcome {
+            Fine fine = jsonToFine(obj);
+            if (fine.getId() <= 0) {
+                return RecordOutcome::Skipped;
             }
-        }
+            fine.setId(0);
+            return m_dbManager->addFine(fine) ? RecordOutcome::Imported : RecordOutcome::Failed;
+        }, result.finesImported, result);
     }
     
+    result.elapsedMs = timer.elapsed();
     return result;
 }
 
+bool DataImporter::importSection(const QJsonArray& records, const QString& sectionName,
+                                 const RecordImporter& importRecord, int& importedCount, ImportResult& result)
+{
+    if (!beginBatch(sectionName, result)) {
+        return false;
+    }
+    
+    // Записи, добавленные в текущем пакете: при откате их нужно вычесть из счетчика
+    int batchImported = 0;
+    int batchRecords = 0;
+    
+    for (const QJsonValue& value : records) {
+        if (!value.isObject()) {
+            continue;
+        }
+        
+        switch (importRecord(value.toObject())) {
+        case RecordOutcome::Imported:
+            importedCount++;
+            batchImported++;
+            break;
+        case RecordOutcome::Failed:
+            result.errors++;
+            break;
+        case RecordOutcome::Skipped:
+            break;
+        }
+        
+        if (m_batchSize > 0 && ++batchRecords >= m_batchSize) {
+            if (!commitBatch(sectionName, batchImported, importedCount, result) ||
+                !beginBatch(sectionName, result)) {
+                return false;
+            }
+            batchImported = 0;
+            batchRecords = 0;
+        }
+    }
+    
+    return commitBatch(sectionName, batchImported, importedCount, result);
+}
+
+bool DataImporter::beginBatch(const QString& sectionName, ImportResult& result)
+{
+    if (!m_dbManager->beginTransaction()) {
+        result.errors++;
+        result.errorMessages.append(QString("Не удалось начать транзакцию импорта (%1)").arg(sectionName));
+        return false;
+    }
+    return true;
+}
+
+bool DataImporter::commitBatch(const QString& sectionName, int batchImported, int& importedCount, ImportResult& result)
+{
+    if (m_dbManager->commitTransaction()) {
+        return true;
+    }
+    
+    m_dbManager->rollbackTransaction();
+    importedCount -= batchImported;
+    result.errors++;
+    result.errorMessages.append(QString("Не удалось зафиксировать пакет импорта (%1), отменено записей: %2")
+                                .arg(sectionName).arg(batchImported));
+    return false;
+}
+
+QSet<int> DataImporter::existingCarIds()
+{
+    QSet<int> ids;
+    m_dbManager->forEachCar(RowFilter(), [&ids](const Car& car) {
+        ids.insert(car.getId());
+        return true;
+    });
+    return ids;
+}
+
+QSet<QString> DataImporter::existingUsernames()
+{
+    QSet<QString> names;
+    m_dbManager->forEachUser(RowFilter(), [&names](const User& user) {
+        names.insert(user.getUsername());
+        return true;
+    });
+    return names;
+}
+
+QSet<int> DataImporter::existingRentalIds()
+{
+    QSet<int> ids;
+    m_dbManager->forEachRental(RowFilter(), [&ids](const Rental& rental) {
+        ids.insert(rental.getId());
+        return true;
+    });
+    return ids;
+}
+
+QSet<int> DataImporter::existingFineIds()
+{
+    QSet<int> ids;
+    m_dbManager->forEachFine(RowFilter(), [&ids](const Fine& fine) {
+        ids.insert(fine.getId());
+        return true;
+    });
+    return ids;
+}
+
 Car DataImporter::jsonToCar(const QJsonObject& obj)
 {
     Car car;
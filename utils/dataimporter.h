@@ -5,6 +5,9 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QJsonDocument>
+#include <QStringList>
+#include <QSet>
+#include <functional>
 #include "../database/databasemanager.h"
 
 struct ImportResult {
@@ -14,8 +17,14 @@ struct ImportResult {
     int finesImported;
     int errors;
     QStringList errorMessages;
+    qint64 elapsedMs; // Длительность импорта
     
-    ImportResult() : carsImported(0), usersImported(0), rentalsImported(0), finesImported(0), errors(0) {}
+    ImportResult() : carsImported(0), usersImported(0), rentalsImported(0), finesImported(0), errors(0), elapsedMs(0) {}
+    
+    int totalImported() const { return carsImported + usersImported + rentalsImported + finesImported; }
+    
+    // Пропускная способность импорта, записей в секунду
+    double recordsPerSecond() const { return elapsedMs > 0 ? totalImported() * 1000.0 / elapsedMs : 0.0; }
 };
 
 class DataImporter
@@ -37,9 +46,35 @@ public:
     
     // Импорт только штрафов
     ImportResult importFinesFromJson(const QString& filePath, bool skipExisting = true);
+    
+    // Число записей в одной транзакции импорта; 0 - вся секция одной транзакцией.
+    // Импорт идет в фоновом потоке, а блокировку записи SQLite держит вся транзакция, поэтому
+    // по умолчанию пакеты ограничены: интерфейс и фоновые задачи успевают писать между ними
+    static const int DEFAULT_BATCH_SIZE = 500;
+    void setBatchSize(int batchSize);
+    int getBatchSize() const { return m_batchSize; }
 
 private:
     DatabaseManager* m_dbManager;
+    int m_batchSize;
+    
+    // Исход обработки одной записи секции
+    enum class RecordOutcome { Imported, Skipped, Failed };
+    typedef std::function<RecordOutcome(const QJsonObject&)> RecordImporter;
+    
+    // Импорт массива записей пакетами по m_batchSize в транзакциях.
+    // Если пакет не удалось зафиксировать, он откатывается, его записи вычитаются
+    // из importedCount и возвращается false - дальнейший импорт прерывается
+    bool importSection(const QJsonArray& records, const QString& sectionName,
+                       const RecordImporter& importRecord, int& importedCount, ImportResult& result);
+    bool beginBatch(const QString& sectionName, ImportResult& result);
+    bool commitBatch(const QString& sectionName, int batchImported, int& importedCount, ImportResult& result);
+    
+    // Существующие ключи читаются одним проходом вместо SELECT на каждую запись
+    QSet<int> existingCarIds();
+    QSet<QString> existingUsernames();
+    QSet<int> existingRentalIds();
+    QSet<int> existingFineIds();
     
     Car jsonToCar(const QJsonObject& obj);
     User jsonToUser(const QJsonObject& obj);
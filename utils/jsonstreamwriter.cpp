@@ -0,0 +1,70 @@
+#include "jsonstreamwriter.h"
+#include <QJsonDocument>
+
+JsonStreamWriter::JsonStreamWriter(QIODevice* device)
+    : m_device(device), m_ok(true), m_firstField(true), m_firstElement(true)
+{
+}
+
+void JsonStreamWriter::beginObject()
+{
+    m_firstField = true;
+    write("{");
+}
+
+void JsonStreamWriter::endObject()
+{
+    write("\n}\n");
+}
+
+void JsonStreamWriter::writeField(const QString& key, const QJsonValue& value)
+{
+    // QJsonDocument в Qt 5 не сериализует отдельное значение,
+    // поэтому пишем объект из одного поля и снимаем внешние скобки
+    QJsonObject wrapper;
+    wrapper.insert(key, value);
+    QByteArray json = QJsonDocument(wrapper).toJson(QJsonDocument::Compact);
+    
+    write(m_firstField ? "\n    " : ",\n    ");
+    m_firstField = false;
+    write(json.mid(1, json.size() - 2));
+}
+
+void JsonStreamWriter::beginArray(const QString& key)
+{
+    writeKey(key);
+    write("[");
+    m_firstElement = true;
+}
+
+void JsonStreamWriter::writeElement(const QJsonObject& element)
+{
+    write(m_firstElement ? "\n        " : ",\n        ");
+    m_firstElement = false;
+    write(QJsonDocument(element).toJson(QJsonDocument::Compact));
+}
+
+void JsonStreamWriter::endArray()
+{
+    write(m_firstElement ? "]" : "\n    ]");
+}
+
+void JsonStreamWriter::write(const QByteArray& data)
+{
+    if (m_ok && m_device->write(data) != data.size()) {
+        m_ok = false;
+    }
+}
+
+void JsonStreamWriter::writeKey(const QString& key)
+{
+    // Ключ экранируется так же, как значения, через QJsonDocument
+    QJsonObject wrapper;
+    wrapper.insert(key, QJsonValue());
+    QByteArray json = QJsonDocument(wrapper).toJson(QJsonDocument::Compact);
+    
+    write(m_firstField ? "\n    " : ",\n    ");
+    m_firstField = false;
+    // {"key":null} -> "key":
+    write(json.mid(1, json.size() - 2 - 4));
+}
@@ -0,0 +1,43 @@
+#ifndef JSONSTREAMWRITER_H
+#define JSONSTREAMWRITER_H
+
+#include <QIODevice>
+#include <QString>
+#include <QJsonObject>
+#include <QJsonValue>
+
+/**
+ * Потоковая запись JSON-объекта верхнего уровня
+ * Элементы массивов пишутся в устройство сразу по одному (компактно, по строке на элемент),
+ * поэтому выгрузка не требует собирать весь документ в памяти
+ */
+class JsonStreamWriter
+{
+public:
+    explicit JsonStreamWriter(QIODevice* device);
+    
+    void beginObject();
+    void endObject();
+    
+    // Поле верхнего уровня со значением
+    void writeField(const QString& key, const QJsonValue& value);
+    
+    // Поле-массив: beginArray, затем writeElement для каждого элемента, затем endArray
+    void beginArray(const QString& key);
+    void writeElement(const QJsonObject& element);
+    void endArray();
+    
+    // true, если все записи в устройство прошли успешно
+    bool isOk() const { return m_ok; }
+
+private:
+    QIODevice* m_device;
+    bool m_ok;
+    bool m_firstField;
+    bool m_firstElement;
+    
+    void write(const QByteArray& data);
+    void writeKey(const QString& key);
+};
+
+#endif // JSONSTREAMWRITER_H
@@ -0,0 +1,37 @@
+#include "timerwheel.h"
+
+TimerWheel::TimerWheel(int slotCount)
+    : m_slots(qMax(1, slotCount)), m_tick(0), m_pending(0)
+{
+}
+
+void TimerWheel::schedule(int id, qint64 delayTicks)
+{
+    const qint64 delay = qMax<qint64>(1, delayTicks);
+    const int slotCount = m_slots.size();
+
+    // Ячейка срабатывания; до нее колесо пройдет еще rounds полных оборотов
+    Entry entry;
+    entry.id = id;
+    entry.rounds = (delay - 1) / slotCount;
+    m_slots[static_cast<int>((m_tick + delay) % slotCount)].append(entry);
+    m_pending++;
+}
+
+QList<int> TimerWheel::advance()
+{
+    m_tick++;
+    QList<int> due;
+    QList<Entry>& slot = m_slots[static_cast<int>(m_tick % m_slots.size())];
+    for (int i = 0; i < slot.size(); ) {
+        if (slot[i].rounds == 0) {
+            due.append(slot[i].id);
+            slot.removeAt(i);
+            m_pending--;
+        } else {
+            slot[i].rounds--;
+            i++;
+        }
+    }
+    return due;
+}
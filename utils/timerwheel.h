@@ -0,0 +1,35 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <QList>
+#include <QVector>
+
+// Хешированное колесо таймеров: постановка задачи и шаг колеса - O(1) в среднем,
+// независимо от числа задач и длины интервалов.
+// Задача с задержкой больше оборота колеса лежит в своей ячейке с числом оставшихся оборотов
+class TimerWheel
+{
+public:
+    explicit TimerWheel(int slotCount = 64);
+
+    // Поставить задачу id на срабатывание через delayTicks шагов (не меньше одного)
+    void schedule(int id, qint64 delayTicks);
+
+    // Сделать один шаг. Возвращает задачи, срок которых наступил; они снимаются с колеса
+    QList<int> advance();
+
+    qint64 getCurrentTick() const { return m_tick; }
+    int getPendingCount() const { return m_pending; }
+
+private:
+    struct Entry {
+        int id;
+        qint64 rounds;
+    };
+
+    QVector<QList<Entry> > m_slots;
+    qint64 m_tick;
+    int m_pending;
+};
+
+#endif // TIMERWHEEL_H